@@ -6,70 +6,79 @@
 #include <array>
 #include <memory>
 #include <type_traits>
+#include <bit>
+#include <iterator>
+#include <algorithm>
+#include <new>
+#include <span>
+#include <numeric>
+#include <functional>
 
 
-// A double ended queue based on std::deque from the STL
+// Returns the default number of elements in a Deque block
+// About 4 KiB of elements, rounded down to a power of two so positions split into a block and a slot with a shift and a mask
 template<class T>
+constexpr std::size_t deque_block_size() noexcept {
+    return std::bit_floor(sizeof(T) >= 4096 ? std::size_t(1) : 4096 / sizeof(T));
+}
+
+
+// A double ended queue based on std::deque from the STL
+// BlockSize is the number of elements per block and must be a power of two
+// Up to SpareBlocks emptied blocks are kept for reuse, so a deque that pushes and pops at a steady size stops allocating
+template<class T, std::size_t BlockSize = deque_block_size<T>(), std::size_t SpareBlocks = 2>
 class Deque{
+    static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0, "The Deque block size must be a power of two");
 public:
+    typedef T value_type;
     typedef std::size_t size_type;
+
+    // Elements per block
+    static constexpr size_type BLOCKSIZE = BlockSize;
+
+    // Position i of the deque is in block i >> BLOCK_SHIFT, slot i & BLOCK_MASK
+    static constexpr size_type BLOCK_SHIFT = static_cast<size_type>(std::countr_zero(BlockSize));
+    static constexpr size_type BLOCK_MASK = BlockSize - 1;
+
+    // Most emptied blocks kept for reuse
+    static constexpr size_type SPARE_BLOCKS = SpareBlocks;
+
 private:
 
     // The internal blocks for the deque structure
+    // One raw allocation holds the header followed by BLOCKSIZE uninitialized slots,
+    // only the slots in [first_offset, first_offset + size) hold constructed elements
     struct Block{
-        static constexpr size_type BLOCKSIZE = 16;
-
-        std::unique_ptr<T[]> data;
-        T* overflow = nullptr;
         size_type size;
         size_type first_offset;
-        bool is_full;
-
-        // Default constructor
-        Block() noexcept
-        : data{new T[BLOCKSIZE]{}}
-        , size{0}
-        , first_offset{0}
-        , is_full{false}
-        {}
+        alignas(T) unsigned char storage[BLOCKSIZE * sizeof(T)];
 
-        // Construct the block to be filled with the given value
-        Block(const T& val)
-        : data{new T[BLOCKSIZE]{}}
-        , size{0}
-        , first_offset{0}
-        , is_full{false} {
-            static_assert(std::is_copy_constructible_v<T>);
-            for(size_type i = 0; i < BLOCKSIZE; ++i){
-                emplace_back(val);
-            }
+        // Allocates an empty block without constructing any elements
+        static Block* create(){
+            Block* b = static_cast<Block*>(::operator new(sizeof(Block), std::align_val_t(alignof(Block))));
+            b->size = 0;
+            b->first_offset = 0;
+            return b;
         }
 
-        // Construct the block to be filled with _size of the given value
-        Block(const T& val, const size_type _size)
-        : data{new T[BLOCKSIZE]{}}
-        , size{0}
-        , first_offset{0} {
-            static_assert(std::is_copy_constructible_v<T>);
-            if(_size > BLOCKSIZE) throw std::out_of_range("Too many values for the Block. Max of 16");
-            for(size_type i = 0; i < _size; ++i){
-                emplace_back(val);
-            }
+        // Frees a block, its elements must already be destroyed
+        static void release(Block* b) noexcept {
+            ::operator delete(b, std::align_val_t(alignof(Block)));
         }
 
-        // Move constructor
-        Block(Block&& other)
-        : data{nullptr}
-        , overflow{std::move(other.overflow)}
-        , size{std::move(other.size)}
-        , first_offset{std::move(other.first_offset)}
-        , is_full{std::move(other.is_full)} {
-            data.swap(other);
+        // Returns the first slot of the block
+        T* elts() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
         }
 
-        // Prevent assignment for internal Blocks
-        Block& operator=(const Block&) = delete;
-        Block& operator=(Block&&) = delete;
+        // Destroys every element in the block
+        void destroy() noexcept {
+            if constexpr(!std::is_trivially_destructible_v<T>){
+                for(size_type i = first_offset; i < first_offset + size; ++i) elts()[i].~T();
+            }
+            size = 0;
+            first_offset = 0;
+        }
 
         // Returns true if you can insert into the front of the block
         bool check_front() const noexcept {
@@ -81,312 +90,216 @@ private:
             return (first_offset + size) < BLOCKSIZE;
         }
 
-        // Create an element in place at the front of the block
+        // Create an element at the front of the block
         template<class... Args>
         void emplace_front(Args&&... args){
-            if(!check_front()) throw std::out_of_range("No space left in the front of Block");
-            if(size == 0) first_offset = BLOCKSIZE;
-            new(data.get() + (first_offset - 1)) T(std::forward<Args>(args)...);
+            const size_type pos = size == 0 ? BLOCKSIZE - 1 : first_offset - 1;
+            ::new(static_cast<void*>(elts() + pos)) T(std::forward<Args>(args)...);
+            first_offset = pos;
             ++size;
-            --first_offset;
-            if(size == BLOCKSIZE) is_full = true;
         }
 
-        // Create an element in place at the back of the block
+        // Create an element at the back of the block
         template<class... Args>
         void emplace_back(Args&&... args){
-            if(!check_back()) throw std::out_of_range("No space left in the back of Block");
-            new(data.get() + (size + first_offset)) T(std::forward<Args>(args)...);
+            ::new(static_cast<void*>(elts() + first_offset + size)) T(std::forward<Args>(args)...);
             ++size;
-            if(size == BLOCKSIZE) is_full = true;
         }
 
-        // Create an element in place at the specified location of the block
-        // Returns true if there was an overflow element that needs to be allocated to another block
-        // Overflow element can be obtained through the overflow member
-        template<class... Args>
-        bool emplace(const size_type _pos, Args&&... args){
-            if(_pos >= size) throw std::out_of_range("Cannot add element outside of Block");
-            T temp(std::forward<Args>(args)...);
-            if(first_offset > 0){
-                for(size_type i = first_offset + _pos - 1; i >= first_offset; --i){
-                    std::swap(temp, data[i]);
-                }
-                new(data.get() + (first_offset - 1)) T(temp);
-                --first_offset;
-                ++size;
-            }else{
-                for(size_type i = _pos; i < size; ++i){
-                    std::swap(temp, data[i]);
-                }
-                if(is_full){
-                    overflow = new T(temp);
-                    return true;
-                }
-                new(data.get() + size) T(temp);
-                ++size;
-            }
-            if(size == BLOCKSIZE) is_full = true;
-
-            return false;
-        }
-
-        // Clear the overflow
-        void clear_overflow() noexcept {
-            delete overflow;
-            overflow = nullptr;
-        }
-
-        // Returns a reference to the specified position
-        // Will throw an exception if out of range
-        T& at(const size_type _pos){
-            if(_pos > size) throw std::out_of_range("Cannot index outside of used elements in the Block");
-            return data.at(_pos + first_offset);
-        }
-
-        // Returns a const reference to the specified position
-        // Will throw an exception if out of range
-        const T& at(const size_type _pos) const {
-            if(_pos >size) throw std::out_of_range("Cannot index outside of used elements in the Block");
-            return data.at(_pos + first_offset);
-        }
-
-        // Returns a reference to the specified position
-        // Will throw an exception if out of range
-        T& at(size_type&& _pos){
-            if(_pos > size) throw std::out_of_range("Cannot index outside of used elements in the Block");
-            return data.at(_pos + first_offset);
+        // Destroy the first element of the block
+        void pop_front() noexcept {
+            elts()[first_offset].~T();
+            ++first_offset;
+            --size;
         }
 
-        // Returns a const reference to the specified position
-        // Will throw an exception if out of range
-        const T& at(size_type&& _pos) const {
-            if(_pos >size) throw std::out_of_range("Cannot index outside of used elements in the Block");
-            return data.at(_pos + first_offset);
+        // Destroy the last element of the block
+        void pop_back() noexcept {
+            elts()[first_offset + size - 1].~T();
+            --size;
         }
+    };
 
-        // Returns a reference to the specified position
-        // Will not throw any exceptions
-        T& operator[](const size_type _pos) noexcept {
-            return data[_pos + first_offset];
-        }
+    size_type Size;                       // Number of elements
+    size_type blocks_total;               // Number of slots in the map
+    size_type blocks_used;                // Number of Blocks currently in use
+    size_type first_offset;               // Offset to the first used block
+    std::unique_ptr<Block*[]> map;        // Pointers to the Blocks, nullptr outside the used range
+    std::array<Block*, SpareBlocks> spare;  // Emptied blocks kept for reuse
+    size_type spare_count;                // Number of blocks in spare
 
-        // Returns a const reference to the specified position
-        // Will not throw any exceptions
-        const T& operator[](const size_type _pos) const noexcept {
-            return data[_pos + first_offset];
-        }
-        
-        // Returns a reference to the specified position
-        // Will not throw any exceptions
-        T& operator[](size_type&& _pos) noexcept {
-            return data[_pos + first_offset];
-        }
+    // Returns the slot of the first element in the first used block
+    size_type start() const noexcept {
+        return empty() ? 0 : map[first_offset]->first_offset;
+    }
 
-        // Returns a const reference to the specified position
-        // Will not throw any exceptions
-        const T& operator[](size_type&& _pos) const noexcept {
-            return data[_pos + first_offset];
-        }
+    // Returns the element at position _pos, counted from the first slot of the first used block
+    T& slot(const size_type _pos) const noexcept {
+        return map[first_offset + (_pos >> BLOCK_SHIFT)]->elts()[_pos & BLOCK_MASK];
+    }
 
-        // Removes the last element from the block, freeing the memory
-        // Will not throw any exceptions
-        void pop_back() noexcept {
-            if(size == 0) return;
-            --size;
-            data[first_offset + size].~T();
-            if(is_full) is_full = false;
-        }
+    // Returns an empty block, a spare one when there is one
+    Block* take_block(){
+        return spare_count > 0 ? spare[--spare_count] : Block::create();
+    }
 
-        // Removes the first element from the block, freeing the memory
-        // Will not throw any exceptions
-        void pop_front() noexcept {
-            if(size == 0) return;
-            --size;
-            data[first_offset].~T();
-            ++first_offset;
-            if(is_full) is_full = false;
-        }
+    // Keeps an empty block as a spare, or frees it when there are SpareBlocks spares already
+    void recycle(Block* b) noexcept {
+        b->size = 0;
+        b->first_offset = 0;
+        if(spare_count < SpareBlocks) spare[spare_count++] = b;
+        else Block::release(b);
+    }
 
-        // Frees all elements in the block
-        void clear() noexcept {
-            while(size > 0) pop_back();
-            first_offset = 0;
-        }
+    // Constructs the first element of a new block and puts the block in map slot i
+    // The block goes back to the spares if the constructor throws
+    template<bool Front, class... Args>
+    void emplace_new_block(const size_type i, Args&&... args){
+        Block* b = take_block();
+        try{
+            if constexpr(Front) b->emplace_front(std::forward<Args>(args)...);
+            else b->emplace_back(std::forward<Args>(args)...);
+        }catch(...){
+            recycle(b);
+            throw;
+        }
+        map[i] = b;
+    }
 
-        ~Block(){
-            clear_overflow();
+    // Make room in the map for one block before the first used one (Front) or after the last used one
+    // The used blocks are recentered in the map, in place when the map is more than twice the blocks needed,
+    // otherwise into a new map with room for the used blocks on both sides
+    // Either way each end is left with about half the free slots, so growth is amortized O(1) per block at both ends
+    // Only the block pointers are copied
+    template<bool Front>
+    void reallocate_map(){
+        const size_type needed = blocks_used + 1;
+        Block** const old_first = map.get() + first_offset;
+
+        if(blocks_total > 2 * needed){
+            const size_type dest = (blocks_total - needed) / 2 + (Front ? 1 : 0);
+            Block** const new_first = map.get() + dest;
+            if(dest < first_offset){
+                std::copy(old_first, old_first + blocks_used, new_first);
+                std::fill(std::max(new_first + blocks_used, old_first), old_first + blocks_used, nullptr);
+            }else{
+                std::copy_backward(old_first, old_first + blocks_used, new_first + blocks_used);
+                std::fill(old_first, std::min(new_first, old_first + blocks_used), nullptr);
+            }
+            first_offset = dest;
+            return;
         }
-    };
 
-    size_type Size;                       // Number of elements
-    size_type blocks_total;               // Total number of allocated Blocks
-    size_type blocks_used;                // Number of Blocks currently in use
-    size_type first_offset;               // Offset to the first used block
-    std::unique_ptr<Block[]> data;            // Array of Blocks
+        const size_type new_total = blocks_total + std::max(blocks_total, needed) + 2;
+        const size_type dest = (new_total - needed) / 2 + (Front ? 1 : 0);
+        std::unique_ptr<Block*[]> temp(new Block*[new_total]());
+        std::copy(old_first, old_first + blocks_used, temp.get() + dest);
+        map.swap(temp);
+        blocks_total = new_total;
+        first_offset = dest;
+    }
 
-    // Double the number of allocated blocks to the front of the deque
-    // REQUIRES first_offset = 0
-    void grow_front() noexcept {
-        if(blocks_total == 0) blocks_total = 1;
-        std::unique_ptr<Block[]> temp(new T[blocks_total * 2]{});
-        for(size_type i = 0; i < blocks_used; ++i){
-            temp[blocks_total + i] = std::move(data[i]);
-        }
-        first_offset = blocks_total;
-        blocks_total *= 2;
-        data.reset(nullptr);
-        data.swap(temp);
+    // Frees the spare blocks
+    void release_spares() noexcept {
+        for(size_type i = 0; i < spare_count; ++i) Block::release(spare[i]);
+        spare_count = 0;
     }
 
-    // Double the number of allocated blocks to the back of the deque
-    void grow_back() noexcept {
-        if(blocks_total == 0) blocks_total = 1;
-        std::unique_ptr<Block[]> temp(new T[blocks_total * 2]{});
-        for(size_type i = 0; i < blocks_used && (first_offset + i) < blocks_total; ++i){
-            temp[first_offset + i] = std::move(data[first_offset + i]);
-        }
-        blocks_total *= 2;
-        data.reset(nullptr);
-        data.swap(temp);
+    // Destroys every element and frees every block
+    void release_all() noexcept {
+        for(size_type i = 0; i < blocks_used; ++i){
+            map[first_offset + i]->destroy();
+            Block::release(map[first_offset + i]);
+        }
+        release_spares();
+        map.reset();
+        Size = 0;
+        blocks_total = 0;
+        blocks_used = 0;
+        first_offset = 0;
     }
 
 protected:
 
     // Base iterator
+    // Points at slot offset of the block in map slot node, all index math is shifts and masks of BLOCKSIZE
     template<class Access_Type>
     class IterType{
         friend class Deque;
     public:
         // Iterator traits to make the iterator stl compliant
         using iterator_category = std::random_access_iterator_tag;
-        using value_type = Access_Type;
+        using value_type = std::remove_cv_t<Access_Type>;
         using difference_type = std::ptrdiff_t;
         using pointer = Access_Type*;
         using reference = Access_Type&;
 
     protected:
-        Block* b;
+        Block** node;
         size_type offset;
 
+        // Moves the iterator by shift positions, across blocks if needed
+        // Arithmetic shifts of the signed position also step backwards correctly
+        void advance(const difference_type shift) noexcept {
+            const difference_type pos = static_cast<difference_type>(offset) + shift;
+            node += pos >> BLOCK_SHIFT;
+            offset = static_cast<size_type>(pos) & BLOCK_MASK;
+        }
+
     public:
 
         // Default constructor
         constexpr IterType() noexcept
-        : b{nullptr},
+        : node{nullptr},
         offset{0}
-        {}  
+        {}
 
-        // Iterator to given block and offset (Assumes pointer is safe to use)
-        IterType(Block* _b, size_type _offset)
-        : b{_b},
+        // Iterator to given map slot and offset (Assumes pointer is safe to use)
+        IterType(Block** _node, size_type _offset)
+        : node{_node},
         offset{_offset}
         {
-            if(offset >= Block::BLOCKSIZE)
+            if(offset >= BLOCKSIZE)
                 throw std::invalid_argument("Offset for iterator must be less than Block::BLOCKSIZE");
         }
 
-        // Copy constructor
-        IterType(const IterType<T>& other) noexcept
-        : b{other.b}
-        , offset{other.offset}
-        {}
-
-        // Move constructor
-        IterType(IterType<T>&& other) noexcept
-        : b{std::move(other.b)}
-        , offset{std::move(other.offset)}
-        {
-            other.b = nullptr;
-            other.offset = 0;
-        }
-
-        // Copy assignment
-        IterType<T>& operator=(const IterType<T>& other) noexcept {
-            // Guard self assignment
-            if(b == other.b && offset == other.offset) return *this;
-
-            b = other.b;
-            offset = other.offset;
-            return *this;
-        }
-
-        // Move assignment
-        IterType<T>& operator=(IterType<T>&& other) noexcept {
-            // Guard self assignment
-            if(b == other.b && offset == other.offset) return *this;
-
-            b = std::move(other.b);
-            offset = std::move(other.offset);
-            other.b = nullptr;
-            other.offset = 0;
-            return *this;
-        }
-
         // Dereference operator overload
-        reference operator*() noexcept {
-            return (*b)[offset];
+        reference operator*() const noexcept {
+            return (*node)->elts()[offset];
         }
 
         // Dereference operator overload
-        pointer operator->() noexcept {
-            return (*b)[offset];
+        pointer operator->() const noexcept {
+            return (*node)->elts() + offset;
         }
 
         // Access operator
-        reference operator[](const size_type& i) noexcept {
-            if((i + offset) >= Block::BLOCKSIZE){
-                size_type _i = i - (Block::BLOCKSIZE - offset);
-                return (*(b + (_i / Block::BLOCKSIZE) + 1))[(_i % Block::BLOCKSIZE)];
-            }
-            return (*(b + (i / Block::BLOCKSIZE)))[offset + (i % Block::BLOCKSIZE)];
-        }
-        reference operator[](size_type&& i) noexcept {
-            if((i + offset) >= Block::BLOCKSIZE){
-                size_type _i = i - (Block::BLOCKSIZE - offset);
-                return (*(b + (_i / Block::BLOCKSIZE) + 1))[(_i % Block::BLOCKSIZE)];
-            }
-            return (*(b + (i / Block::BLOCKSIZE)))[offset + (i % Block::BLOCKSIZE)];
-        }
-        const reference operator[](const size_type& i) const noexcept {
-            if((i + offset) >= Block::BLOCKSIZE){
-                size_type _i = i - (Block::BLOCKSIZE - offset);
-                return (*(b + (_i / Block::BLOCKSIZE) + 1))[(_i % Block::BLOCKSIZE)];
-            }
-            return (*(b + (i / Block::BLOCKSIZE)))[offset + (i % Block::BLOCKSIZE)];
-        }
-        const reference operator[](size_type&& i) const noexcept {
-            if((i + offset) >= Block::BLOCKSIZE){
-                size_type _i = i - (Block::BLOCKSIZE - offset);
-                return (*(b + (_i / Block::BLOCKSIZE) + 1))[(_i % Block::BLOCKSIZE)];
-            }
-            return (*(b + (i / Block::BLOCKSIZE)))[offset + (i % Block::BLOCKSIZE)];
+        reference operator[](const difference_type i) const noexcept {
+            IterType<Access_Type> temp(*this);
+            temp.advance(i);
+            return *temp;
         }
 
         // Increment
         IterType<Access_Type>& operator++() noexcept {
             ++offset;
-            if(offset >= Block::BLOCKSIZE){
-                ++b;
+            if(offset == BLOCKSIZE){
+                ++node;
                 offset = 0;
             }
             return *this;
         }
         IterType<Access_Type> operator++(int) noexcept {
             IterType<Access_Type> temp(*this);
-            ++offset;
-            if(offset >= Block::BLOCKSIZE){
-                ++b;
-                offset = 0;
-            }
+            ++*this;
             return temp;
         }
 
         // Decrement
         IterType<Access_Type>& operator--() noexcept {
             if(offset == 0){
-                offset = Block::BLOCKSIZE - 1;
-                --b;
+                offset = BLOCKSIZE - 1;
+                --node;
             }else{
                 --offset;
             }
@@ -394,125 +307,62 @@ protected:
         }
         IterType<Access_Type> operator--(int) noexcept {
             IterType<Access_Type> temp(*this);
-            if(offset == 0){
-                offset = Block::BLOCKSIZE - 1;
-                --b;
-            }else{
-                --offset;
-            }
+            --*this;
             return temp;
         }
 
         // Compound Assignments
-        IterType<Access_Type>& operator+=(const size_type& shift) noexcept {
-            offset += shift;
-            b += offset / Block::BLOCKSIZE;
-            offset = offset % Block::BLOCKSIZE;
-            return *this;
-        }
-        IterType<Access_Type>& operator+=(size_type&& shift) noexcept {
-            offset += std::move(shift);
-            b += offset / Block::BLOCKSIZE;
-            offset = offset % Block::BLOCKSIZE;
+        IterType<Access_Type>& operator+=(const difference_type shift) noexcept {
+            advance(shift);
             return *this;
         }
-        IterType<Access_Type>& operator-=(size_type shift) noexcept {
-            if(shift > offset){
-                if((shift % Block::BLOCKSIZE) > 0){
-                    shift -= shift % Block::BLOCKSIZE;
-                    if((shift % Block::BLOCKSIZE) > offset){
-                        offset = (offset + Block::BLOCKSIZE) - (shift % Block::BLOCKSIZE);
-                        --b;
-                    }else{
-                        offset -= shift % Block::BLOCKSIZE;
-                        --b;
-                    }
-                }
-                b -= shift / Block::BLOCKSIZE;
-            }else{
-                offset -= shift;
-            }
-            return *this;
-        }
-        IterType<Access_Type>& operator-=(size_type&& shift) noexcept {
-            size_type _shift = std::move(shift);
-            if(_shift > offset){
-                if((_shift % Block::BLOCKSIZE) > 0){
-                    _shift -= _shift % Block::BLOCKSIZE;
-                    if((_shift % Block::BLOCKSIZE) > offset){
-                        offset = (offset + Block::BLOCKSIZE) - (_shift % Block::BLOCKSIZE);
-                        --b;
-                    }else{
-                        offset -= _shift % Block::BLOCKSIZE;
-                        --b;
-                    }
-                }
-                b -= shift / Block::BLOCKSIZE;
-            }else{
-                offset -= _shift;
-            }
+        IterType<Access_Type>& operator-=(const difference_type shift) noexcept {
+            advance(-shift);
             return *this;
         }
 
         // Addition
-        friend IterType<Access_Type> operator+(IterType<Access_Type> it, const size_type& shift) noexcept {
-            return std::move(it += shift);
-        }
-        friend IterType<Access_Type> operator+(const size_type& shift, IterType<Access_Type> it) noexcept {
-            return std::move(it += shift);
-        }
-        friend IterType<Access_Type> operator+(IterType<Access_Type> it, size_type&& shift) noexcept {
-            return std::move(it += std::move(shift));
+        friend IterType<Access_Type> operator+(IterType<Access_Type> it, const difference_type shift) noexcept {
+            return it += shift;
         }
-        friend IterType<Access_Type> operator+(size_type&& shift, IterType<Access_Type> it) noexcept {
-            return std::move(it += std::move(shift));
+        friend IterType<Access_Type> operator+(const difference_type shift, IterType<Access_Type> it) noexcept {
+            return it += shift;
         }
 
         // Subtraction
-        friend IterType<Access_Type> operator-(IterType<Access_Type> it, const size_type& shift) noexcept {
-            return std::move(it -= shift);
-        }
-        friend IterType<Access_Type> operator-(const size_type& shift, IterType<Access_Type> it) noexcept {
-            return std::move(it -= shift);
-        }
-        friend IterType<Access_Type> operator-(IterType<Access_Type> it, size_type&& shift) noexcept {
-            return std::move(it -= std::move(shift));
-        }
-        friend IterType<Access_Type> operator-(size_type&& shift, IterType<Access_Type> it) noexcept {
-            return std::move(it -= std::move(shift));
+        friend IterType<Access_Type> operator-(IterType<Access_Type> it, const difference_type shift) noexcept {
+            return it -= shift;
         }
 
         // Difference
         difference_type operator-(const IterType<Access_Type>& other) const noexcept {
-            return (static_cast<difference_type>(b - other.b) * Block::BLOCKSIZE)
-            + static_cast<difference_type>((b.data.get() + offset) - (other.b.data.get() + other.offset));
+            return static_cast<difference_type>(node - other.node) * static_cast<difference_type>(BLOCKSIZE)
+            + static_cast<difference_type>(offset) - static_cast<difference_type>(other.offset);
         }
 
         // Equality operator
         bool operator==(const IterType<Access_Type>& other) const noexcept {
-            return b == other.b && offset == other.offset;
+            return node == other.node && offset == other.offset;
         }
 
         // Inequality operator
         bool operator!=(const IterType<Access_Type>& other) const noexcept {
-            return b != other.b || offset != other.offset;
+            return node != other.node || offset != other.offset;
         }
 
         // Comparison operator
         bool operator<(const IterType<Access_Type>& other) const noexcept {
-            return b == other.b ? offset < other.offset : b < other.b;
+            return node == other.node ? offset < other.offset : node < other.node;
         }
         bool operator<=(const IterType<Access_Type>& other) const noexcept {
-            return b == other.b ? offset <= other.offset : b <= other.b;
+            return node == other.node ? offset <= other.offset : node <= other.node;
         }
         bool operator>(const IterType<Access_Type>& other) const noexcept {
-            return b == other.b ? offset < other.offset : b < other.b;
+            return other < *this;
         }
         bool operator>=(const IterType<Access_Type>& other) const noexcept {
-            return b == other.b ? offset <= other.offset : b <= other.b;
+            return other <= *this;
         }
-
-        ~IterType() = default;
     };
 
 public:
@@ -524,24 +374,75 @@ public:
     typedef IterType<const T> const_iterator;
 
     // Default constructor
-    constexpr Deque()
+    Deque() noexcept
     : Size{0}
     , blocks_total{0}
     , blocks_used{0}
     , first_offset{0}
-    , data{nullptr}
+    , map{nullptr}
+    , spare{}
+    , spare_count{0}
     {}
 
     // Size constructor
-    // Creates a Deque of size _size
-    Deque(size_type _size)
-    : Size{_size}
-    , blocks_total{(_size + Block::BLOCKSIZE - 1) / Block::BLOCKSIZE}
-    , blocks_used{(_size + Block::BLOCKSIZE - 1) / Block::BLOCKSIZE}
-    , first_offset{0}
-    , data{new Block[((_size + Block::BLOCKSIZE - 1) / Block::BLOCKSIZE)]{}}
+    // Creates a Deque of _size default values
+    explicit Deque(size_type _size)
+    : Deque() {
+        for(size_type i = 0; i < _size; ++i){
+            emplace_back();
+        }
+    }
+
+    // Copy constructor
+    Deque(const Deque& other)
+    : Deque() {
+        for(size_type i = 0; i < other.size(); ++i){
+            emplace_back(other[i]);
+        }
+    }
+
+    // Move constructor
+    Deque(Deque&& other) noexcept
+    : Size{std::exchange(other.Size, 0)}
+    , blocks_total{std::exchange(other.blocks_total, 0)}
+    , blocks_used{std::exchange(other.blocks_used, 0)}
+    , first_offset{std::exchange(other.first_offset, 0)}
+    , map{std::move(other.map)}
+    , spare{other.spare}
+    , spare_count{std::exchange(other.spare_count, 0)}
     {}
 
+    // Copy assignment
+    Deque& operator=(const Deque& other){
+        // Guard self assignment
+        if(this == &other) return *this;
+
+        Deque temp(other);
+        swap(temp);
+        return *this;
+    }
+
+    // Move assignment
+    Deque& operator=(Deque&& other) noexcept {
+        // Guard self assignment
+        if(this == &other) return *this;
+
+        release_all();
+        swap(other);
+        return *this;
+    }
+
+    // Swaps the contents of two deques
+    void swap(Deque& other) noexcept {
+        std::swap(Size, other.Size);
+        std::swap(blocks_total, other.blocks_total);
+        std::swap(blocks_used, other.blocks_used);
+        std::swap(first_offset, other.first_offset);
+        map.swap(other.map);
+        std::swap(spare, other.spare);
+        std::swap(spare_count, other.spare_count);
+    }
+
     // Returns the number of elements in the deque
     constexpr size_type size() const noexcept {
         return Size;
@@ -552,69 +453,53 @@ public:
         return size() == 0;
     }
 
-    // Returns the capacity of the underlying storage currently allocated
+    // Returns the number of elements the map can reach before it has to grow
     constexpr size_type capacity() const noexcept {
-        return blocks_total * Block::BLOCKSIZE;
+        return blocks_total * BLOCKSIZE;
     }
 
     // Returns a reference to the specified element
     T& at(const size_type _pos){
-        if(_pos > size()) throw std::out_of_range("ERROR: Cannot index outside of range.");
-        return data[first_offset + (_pos / Block::BLOCKSIZE)].at(_pos % Block::BLOCKSIZE);
-    }
-    T& at(size_type&& _pos){
-        if(_pos > size()) throw std::out_of_range("ERROR: Cannot index outside of range.");
-        return data[first_offset + (_pos / Block::BLOCKSIZE)].at(_pos % Block::BLOCKSIZE);
+        if(_pos >= size()) throw std::out_of_range("ERROR: Cannot index outside of range.");
+        return slot(start() + _pos);
     }
 
     // Returns a const reference to the specified element
     const T& at(const size_type _pos) const {
-        if(_pos > size()) throw std::out_of_range("ERROR: Cannot index outside of range.");
-        return data[first_offset + (_pos / Block::BLOCKSIZE)].at(_pos % Block::BLOCKSIZE);
-    }
-    const T& at(size_type&& _pos) const {
-        if(_pos > size()) throw std::out_of_range("ERROR: Cannot index outside of range.");
-        return data[first_offset + (_pos / Block::BLOCKSIZE)].at(_pos % Block::BLOCKSIZE);
+        if(_pos >= size()) throw std::out_of_range("ERROR: Cannot index outside of range.");
+        return slot(start() + _pos);
     }
 
     // Returns a reference to the specified element without throwing any exceptions
     T& operator[](const size_type _pos) noexcept {
-        return data[first_offset + (_pos / Block::BLOCKSIZE)][_pos % Block::BLOCKSIZE];
-    }
-    T& operator[](size_type&& _pos) noexcept {
-        return data[first_offset + (_pos / Block::BLOCKSIZE)][_pos % Block::BLOCKSIZE];
+        return slot(start() + _pos);
     }
 
     // Returns a const reference to the specified element without throwing any exceptions
     const T& operator[](const size_type _pos) const noexcept {
-        return data[first_offset + (_pos / Block::BLOCKSIZE)][_pos % Block::BLOCKSIZE];
-    }
-    const T& operator[](size_type&& _pos) const noexcept {
-        return data[first_offset + (_pos / Block::BLOCKSIZE)][_pos % Block::BLOCKSIZE];
+        return slot(start() + _pos);
     }
 
     // Returns a reference to the first element in the Deque
     T& front(){
-        if(empty()) throw std::out_of_range("ERROR: Cannot index outside of range.");
-        return data[first_offset].at(0);
+        return at(0);
     }
 
     // Returns a const reference to the first element in the Deque
     const T& front() const {
-        if(empty()) throw std::out_of_range("ERROR: Cannot index outside of range.");
-        return data[first_offset].at(0);
+        return at(0);
     }
 
     // Returns a reference to the last element in the Deque
     T& back(){
         if(empty()) throw std::out_of_range("ERROR: Cannot index outside of range.");
-        return data[first_offset + blocks_used - 1].at((Size - 1) % Block::BLOCKSIZE);
+        return at(size() - 1);
     }
 
     // Returns a const reference to the last element in the Deque
     const T& back() const {
         if(empty()) throw std::out_of_range("ERROR: Cannot index outside of range.");
-        return data[first_offset + blocks_used - 1].at((Size - 1) % Block::BLOCKSIZE);
+        return at(size() - 1);
     }
 
     // Inserts the specified value to the front of the deque
@@ -628,17 +513,22 @@ public:
     // Creates the specified value to the front of the deque in place
     template<class... Args>
     void emplace_front(Args&&... args){
-        if(first_offset <= 0){
-            if(empty() || !data[0].check_front()) grow_front();
+        if(empty()){
+            if(blocks_total == 0) reallocate_map<false>();
+            emplace_new_block<true>(first_offset, std::forward<Args>(args)...);
+            blocks_used = 1;
+        }else if(map[first_offset]->check_front()){
+            map[first_offset]->emplace_front(std::forward<Args>(args)...);
+        }else{
+            if(first_offset == 0) reallocate_map<true>();
+            emplace_new_block<true>(first_offset - 1, std::forward<Args>(args)...);
+            --first_offset;
+            ++blocks_used;
         }
-
-        if(!data[first_offset].check_front()) --first_offset;
-
-        data[first_offset].emplace_front(std::move(args...));
         ++Size;
     }
 
-    // Inserts the specified value to the front of the deque
+    // Inserts the specified value to the back of the deque
     void push_back(const T& _val){
         emplace_back(_val);
     }
@@ -646,49 +536,201 @@ public:
         emplace_back(std::move(_val));
     }
 
-    // Creates the specified value to the front of the deque in place
+    // Creates the specified value to the back of the deque in place
     template<class... Args>
     void emplace_back(Args&&... args){
-        if((first_offset + blocks_used) >= blocks_total){
-            if(empty() || !data[first_offset + blocks_used].check_back()) grow_back();
+        if(empty()){
+            if(blocks_total == 0) reallocate_map<false>();
+            emplace_new_block<false>(first_offset, std::forward<Args>(args)...);
+            blocks_used = 1;
+        }else if(map[first_offset + blocks_used - 1]->check_back()){
+            map[first_offset + blocks_used - 1]->emplace_back(std::forward<Args>(args)...);
+        }else{
+            if(first_offset + blocks_used == blocks_total) reallocate_map<false>();
+            emplace_new_block<false>(first_offset + blocks_used, std::forward<Args>(args)...);
+            ++blocks_used;
+        }
+        ++Size;
+    }
+
+    // Removes the first element of the deque
+    void pop_front(){
+        if(empty()) throw std::out_of_range("Cannot remove element from empty Deque");
+        Block* b = map[first_offset];
+        b->pop_front();
+        if(b->size == 0){
+            recycle(std::exchange(map[first_offset], nullptr));
+            ++first_offset;
+            --blocks_used;
         }
+        if(--Size == 0) first_offset = blocks_total / 2;
+    }
 
-        if(!data[first_offset + blocks_used].check_back()) ++blocks_used;
+    // Removes the last element of the deque
+    void pop_back(){
+        if(empty()) throw std::out_of_range("Cannot remove element from empty Deque");
+        Block* b = map[first_offset + blocks_used - 1];
+        b->pop_back();
+        if(b->size == 0){
+            recycle(std::exchange(map[first_offset + blocks_used - 1], nullptr));
+            --blocks_used;
+        }
+        if(--Size == 0) first_offset = blocks_total / 2;
+    }
 
-        data[first_offset + blocks_used].emplace_back(std::move(args...));
-        ++Size;
+    // Removes every element, keeping the map and up to SpareBlocks blocks for reuse
+    void clear() noexcept {
+        for(size_type i = 0; i < blocks_used; ++i){
+            map[first_offset + i]->destroy();
+            recycle(std::exchange(map[first_offset + i], nullptr));
+        }
+        Size = 0;
+        blocks_used = 0;
+        first_offset = blocks_total / 2;
+    }
+
+    // Frees the spare blocks and shrinks the map to the blocks in use
+    void shrink_to_fit(){
+        release_spares();
+        if(empty()){
+            map.reset();
+            blocks_total = 0;
+            first_offset = 0;
+        }else if(blocks_used < blocks_total){
+            std::unique_ptr<Block*[]> temp(new Block*[blocks_used]);
+            std::copy(map.get() + first_offset, map.get() + first_offset + blocks_used, temp.get());
+            map.swap(temp);
+            blocks_total = blocks_used;
+            first_offset = 0;
+        }
+    }
+
+    // Returns the number of emptied blocks kept for reuse
+    constexpr size_type spare_blocks() const noexcept {
+        return spare_count;
+    }
+
+    // Returns the number of blocks holding elements, one segment each
+    constexpr size_type segment_count() const noexcept {
+        return blocks_used;
+    }
+
+    // Returns the elements of block s as one contiguous span, so loops can run over plain arrays
+    // Segments are in deque order, the span is empty past the last block
+    std::span<T> segment(const size_type s) noexcept {
+        if(s >= blocks_used) return std::span<T>();
+        Block* b = map[first_offset + s];
+        return std::span<T>(b->elts() + b->first_offset, b->size);
+    }
+
+    // Returns the contiguous const elements of block s
+    std::span<const T> segment(const size_type s) const noexcept {
+        if(s >= blocks_used) return std::span<const T>();
+        Block* b = map[first_offset + s];
+        return std::span<const T>(b->elts() + b->first_offset, b->size);
+    }
+
+    // Calls f with the span of every segment in order
+    // The loop over each span has no block boundary checks, so f can be vectorized
+    template<class F>
+    void for_each_segment(F&& f){
+        for(size_type s = 0; s < blocks_used; ++s) f(segment(s));
+    }
+    template<class F>
+    void for_each_segment(F&& f) const {
+        for(size_type s = 0; s < blocks_used; ++s) f(segment(s));
     }
 
     // Returns an iterator to the first element
     iterator begin() const {
         if(empty()) throw std::out_of_range("Cannot create iterator on empty Deque");
-        return iterator(data.get() + first_offset, data[first_offset].first_offset);
+        return iterator(map.get() + first_offset, start());
     }
 
     // Returns an iterator to one past the last element
     iterator end() const {
         if(empty()) throw std::out_of_range("Cannot create iterator on empty Deque");
-        if(data[first_offset + blocks_used].check_back())
-            return iterator(data.get() + first_offset + blocks_used, data[first_offset + blocks_used].first_offset + 1);
-        return iterator(data.get() + first_offset + blocks_used + 1, 0);
+        const size_type last = start() + Size;
+        return iterator(map.get() + first_offset + (last >> BLOCK_SHIFT), last & BLOCK_MASK);
     }
 
     // Returns a const_iterator to the first element
     const_iterator cbegin() const {
         if(empty()) throw std::out_of_range("Cannot create iterator on empty Deque");
-        return const_iterator(data.get() + first_offset, data[first_offset].first_offset);
+        return const_iterator(map.get() + first_offset, start());
     }
 
     // Returns an iterator to one past the last element
     const_iterator cend() const {
         if(empty()) throw std::out_of_range("Cannot create iterator on empty Deque");
-        if(data[first_offset + blocks_used].check_back())
-            return const_iterator(data.get() + first_offset + blocks_used, data[first_offset + blocks_used].first_offset + 1);
-        return const_iterator(data.get() + first_offset + blocks_used + 1, 0);
+        const size_type last = start() + Size;
+        return const_iterator(map.get() + first_offset + (last >> BLOCK_SHIFT), last & BLOCK_MASK);
     }
 
-    ~Deque() = default;
+    // Destructor
+    ~Deque(){
+        release_all();
+    }
 
 };
 
-#endif
\ No newline at end of file
+
+// Algorithms over a whole Deque, run segment by segment on plain pointers instead of through Deque iterators
+
+// Sets every element of deq to value
+template<class T, std::size_t BlockSize, std::size_t SpareBlocks>
+void fill(Deque<T, BlockSize, SpareBlocks>& deq, const T& value){
+    deq.for_each_segment([&](const std::span<T> seg){
+        std::fill(seg.data(), seg.data() + seg.size(), value);
+    });
+}
+
+// Copies every element of deq to out and returns the end of the output
+template<class T, std::size_t BlockSize, std::size_t SpareBlocks, class OutputIt>
+OutputIt copy(const Deque<T, BlockSize, SpareBlocks>& deq, OutputIt out){
+    deq.for_each_segment([&](const std::span<const T> seg){
+        out = std::copy(seg.data(), seg.data() + seg.size(), out);
+    });
+    return out;
+}
+
+// Returns the position of the first element equal to value, or deq.size() if there is none
+template<class T, std::size_t BlockSize, std::size_t SpareBlocks, class U>
+std::size_t find(const Deque<T, BlockSize, SpareBlocks>& deq, const U& value){
+    std::size_t pos = 0;
+    for(std::size_t s = 0; s < deq.segment_count(); ++s){
+        const std::span<const T> seg = deq.segment(s);
+        const T* const found = std::find(seg.data(), seg.data() + seg.size(), value);
+        if(found != seg.data() + seg.size()) return pos + static_cast<std::size_t>(found - seg.data());
+        pos += seg.size();
+    }
+    return pos;
+}
+
+// Returns init combined with every element of deq in order through op
+template<class T, std::size_t BlockSize, std::size_t SpareBlocks, class U, class Op = std::plus<>>
+U accumulate(const Deque<T, BlockSize, SpareBlocks>& deq, U init, Op op = {}){
+    deq.for_each_segment([&](const std::span<const T> seg){
+        init = std::accumulate(seg.data(), seg.data() + seg.size(), std::move(init), op);
+    });
+    return init;
+}
+
+// Writes f(x) for every element x of deq to out and returns the end of the output
+template<class T, std::size_t BlockSize, std::size_t SpareBlocks, class OutputIt, class F>
+OutputIt transform(const Deque<T, BlockSize, SpareBlocks>& deq, OutputIt out, F f){
+    deq.for_each_segment([&](const std::span<const T> seg){
+        out = std::transform(seg.data(), seg.data() + seg.size(), out, f);
+    });
+    return out;
+}
+
+// Replaces every element x of deq with f(x)
+template<class T, std::size_t BlockSize, std::size_t SpareBlocks, class F>
+void transform(Deque<T, BlockSize, SpareBlocks>& deq, F f){
+    deq.for_each_segment([&](const std::span<T> seg){
+        std::transform(seg.data(), seg.data() + seg.size(), seg.data(), f);
+    });
+}
+
+#endif
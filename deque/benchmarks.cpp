@@ -0,0 +1,300 @@
+// Benchmarks for Deque
+// Usage: bench.exe [benchmark] [elements]
+// Runs every benchmark when no name is given
+
+#include "Deque.hpp"
+#include "../vector/Vector.hpp"
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <numeric>
+#include <vector>
+
+
+// Number of calls to the global operator new, so benchmarks can report allocations per operation
+static std::size_t allocations = 0;
+
+void* operator new(const std::size_t bytes){
+    ++allocations;
+    if(void* p = std::malloc(bytes == 0 ? 1 : bytes)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t bytes, const std::align_val_t align){
+    ++allocations;
+    const std::size_t a = static_cast<std::size_t>(align);
+    if(void* p = std::aligned_alloc(a, (bytes + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+
+// Prevents the optimizer from discarding a computed value
+template<class T>
+void keep(const T& val){
+    asm volatile("" : : "r,m"(val) : "memory");
+}
+
+
+// Returns the wall time taken by f in seconds
+template<class F>
+double time_s(F&& f){
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+
+// Prints the best of three runs of f, which performs ops operations
+template<class F>
+void report_ops(const char* name, const std::size_t ops, F&& f){
+    double best = 1e30;
+    for(int rep = 0; rep < 3; ++rep){
+        best = std::min(best, time_s(f));
+    }
+    std::printf("  %-26s %10.3f ms %10.2f ns/op\n", name, best * 1e3, best * 1e9 / static_cast<double>(ops));
+}
+
+
+// An element of Bytes bytes, the first byte carries a value so reads cannot be skipped
+template<std::size_t Bytes>
+struct Elem{
+    unsigned char bytes[Bytes];
+
+    Elem() noexcept : bytes{} {}
+    explicit Elem(const std::size_t i) noexcept : bytes{} {
+        bytes[0] = static_cast<unsigned char>(i);
+    }
+};
+
+
+// Fills a container with n elements at the back, then at the front
+template<class D>
+void push_both(const char* name, const std::size_t n){
+    report_ops(name, 2 * n, [n]{
+        D back;
+        for(std::size_t i = 0; i < n; ++i) back.push_back(typename D::value_type(i));
+        D front;
+        for(std::size_t i = 0; i < n; ++i) front.push_front(typename D::value_type(i));
+        keep(back[n / 2].bytes[0] + front[n / 2].bytes[0]);
+    });
+}
+
+template<std::size_t Bytes>
+void push_sizes(const std::size_t n){
+    std::printf("-- %zu byte elements, default Deque block of %zu --\n", Bytes, Deque<Elem<Bytes>>::BLOCKSIZE);
+    push_both<Deque<Elem<Bytes>, 16>>("Deque<16>", n);
+    push_both<Deque<Elem<Bytes>>>("Deque", n);
+    push_both<std::deque<Elem<Bytes>>>("std::deque", n);
+}
+
+void bench_push(const std::size_t n){
+    std::printf("== push_back then push_front of %zu elements ==\n", n);
+    push_sizes<1>(n);
+    push_sizes<8>(n);
+    push_sizes<64>(n);
+    push_sizes<256>(n);
+}
+
+
+// operator[] at random positions, the block and slot of each position are found by a shift and a mask
+template<class D>
+void random_reads(const char* name, const std::size_t n, const std::vector<std::size_t>& positions){
+    D deq;
+    for(std::size_t i = 0; i < n; ++i) deq.push_back(typename D::value_type(i));
+    report_ops(name, positions.size(), [&]{
+        unsigned total = 0;
+        for(const std::size_t pos : positions) total += deq[pos].bytes[0];
+        keep(total);
+    });
+}
+
+template<std::size_t Bytes>
+void random_sizes(const std::size_t n, const std::vector<std::size_t>& positions){
+    std::printf("-- %zu byte elements, default Deque block of %zu --\n", Bytes, Deque<Elem<Bytes>>::BLOCKSIZE);
+    random_reads<Deque<Elem<Bytes>, 16>>("Deque<16>[]", n, positions);
+    random_reads<Deque<Elem<Bytes>>>("Deque[]", n, positions);
+    random_reads<std::deque<Elem<Bytes>>>("std::deque[]", n, positions);
+}
+
+void bench_random(const std::size_t n){
+    constexpr std::size_t READS = 10000000;
+    std::printf("== %zu random operator[] reads over %zu elements ==\n", READS, n);
+    std::uint64_t state = 88172645463325252ULL;
+    const auto next = [&state]{
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+
+    std::vector<std::size_t> positions(READS);
+    for(std::size_t& pos : positions) pos = static_cast<std::size_t>(next() % n);
+
+    random_sizes<1>(n, positions);
+    random_sizes<8>(n, positions);
+    random_sizes<64>(n, positions);
+    random_sizes<256>(n, positions);
+}
+
+
+// Pushes n elements choosing the end with pattern(i), true meaning the front
+// Reports the allocations per push, blocks and map reallocations together
+template<class D, class P>
+void mixed_pushes(const char* name, const std::size_t n, P pattern){
+    std::size_t made = 0;
+    report_ops(name, n, [&]{
+        const std::size_t before = allocations;
+        D deq;
+        for(std::size_t i = 0; i < n; ++i){
+            if(pattern(i)) deq.push_front(typename D::value_type(i));
+            else deq.push_back(typename D::value_type(i));
+        }
+        made = allocations - before;
+        keep(deq[n / 2].bytes[0]);
+    });
+    std::printf("  %-26s %10.4f allocations/op\n", "", static_cast<double>(made) / static_cast<double>(n));
+}
+
+template<class P>
+void mixed_pattern(const char* pattern_name, const std::size_t n, P pattern){
+    std::printf("-- %s, 8 byte elements --\n", pattern_name);
+    mixed_pushes<Deque<Elem<8>, 1>>("Deque<1>", n, pattern);
+    mixed_pushes<Deque<Elem<8>, 16>>("Deque<16>", n, pattern);
+    mixed_pushes<Deque<Elem<8>>>("Deque", n, pattern);
+    mixed_pushes<std::deque<Elem<8>>>("std::deque", n, pattern);
+}
+
+void bench_mixed(const std::size_t n){
+    std::printf("== %zu pushes split between push_front and push_back ==\n", n);
+    mixed_pattern("alternating", n, [](const std::size_t i){ return i % 2 == 0; });
+    mixed_pattern("runs of 1000 at each end", n, [](const std::size_t i){ return (i / 1000) % 2 == 0; });
+    mixed_pattern("one front per 8 back", n, [](const std::size_t i){ return i % 8 == 0; });
+    mixed_pattern("random", n, [](const std::size_t i){
+        std::uint64_t x = i * 0x9E3779B97F4A7C15ULL;
+        x ^= x >> 29;
+        return (x & 1) != 0;
+    });
+}
+
+
+// A FIFO holding depth elements: every operation pops the front and pushes a new element at the back
+// Reports the allocations per operation once the queue is at its steady size
+template<class D>
+void fifo_churn(const char* name, const std::size_t ops, const std::size_t depth){
+    D deq;
+    for(std::size_t i = 0; i < depth; ++i) deq.push_back(typename D::value_type(i));
+    std::size_t before = 0;
+    report_ops(name, ops, [&]{
+        before = allocations;
+        for(std::size_t i = 0; i < ops; ++i){
+            deq.pop_front();
+            deq.push_back(typename D::value_type(i));
+        }
+        keep(deq.front().bytes[0]);
+    });
+    std::printf("  %-26s %10.4f allocations/op\n", "", static_cast<double>(allocations - before) / static_cast<double>(ops));
+}
+
+template<std::size_t Bytes>
+void fifo_sizes(const std::size_t ops, const std::size_t depth){
+    std::printf("-- %zu byte elements, default Deque block of %zu --\n", Bytes, Deque<Elem<Bytes>>::BLOCKSIZE);
+    fifo_churn<Deque<Elem<Bytes>, 16, 0>>("Deque<16> no spares", ops, depth);
+    fifo_churn<Deque<Elem<Bytes>, 16>>("Deque<16>", ops, depth);
+    fifo_churn<Deque<Elem<Bytes>>>("Deque", ops, depth);
+    fifo_churn<std::deque<Elem<Bytes>>>("std::deque", ops, depth);
+}
+
+void bench_fifo(const std::size_t n){
+    constexpr std::size_t DEPTH = 1000;
+    std::printf("== %zu pop_front + push_back operations on a FIFO of %zu elements ==\n", n, DEPTH);
+    fifo_sizes<8>(n, DEPTH);
+    fifo_sizes<64>(n, DEPTH);
+}
+
+
+// Scans of n elements through Deque iterators, Deque segments and a Vector
+// The iterator loops check the block boundary on every step, the segment and Vector loops run over plain arrays
+template<class T>
+void scan_type(const char* type_name, const std::size_t n){
+    std::printf("-- %s --\n", type_name);
+    Deque<T> deq;
+    Vector<T> vec;
+    for(std::size_t i = 0; i < n; ++i){
+        deq.push_back(static_cast<T>(i % 1000));
+        vec.push_back(static_cast<T>(i % 1000));
+    }
+
+    report_ops("sum Deque iterators", n, [&]{ keep(std::accumulate(deq.cbegin(), deq.cend(), T(0))); });
+    report_ops("sum Deque segments", n, [&]{ keep(accumulate(deq, T(0))); });
+    report_ops("sum Vector", n, [&]{ keep(std::accumulate(vec.data(), vec.data() + vec.size(), T(0))); });
+
+    report_ops("fill Deque iterators", n, [&]{ std::fill(deq.begin(), deq.end(), T(3)); keep(deq[n / 2]); });
+    report_ops("fill Deque segments", n, [&]{ fill(deq, T(3)); keep(deq[n / 2]); });
+    report_ops("fill Vector", n, [&]{ std::fill(vec.data(), vec.data() + vec.size(), T(3)); keep(vec[n / 2]); });
+
+    const auto twice = [](const T x){ return x * T(2) + T(1); };
+    report_ops("transform Deque iterators", n, [&]{ std::transform(deq.begin(), deq.end(), deq.begin(), twice); keep(deq[n / 2]); });
+    report_ops("transform Deque segments", n, [&]{ transform(deq, twice); keep(deq[n / 2]); });
+    report_ops("transform Vector", n, [&]{ std::transform(vec.data(), vec.data() + vec.size(), vec.data(), twice); keep(vec[n / 2]); });
+
+    Vector<T> out(n);
+    report_ops("copy Deque iterators", n, [&]{ std::copy(deq.cbegin(), deq.cend(), out.data()); keep(out[n / 2]); });
+    report_ops("copy Deque segments", n, [&]{ copy(deq, out.data()); keep(out[n / 2]); });
+    report_ops("copy Vector", n, [&]{ std::copy(vec.data(), vec.data() + vec.size(), out.data()); keep(out[n / 2]); });
+
+    // The value is not present, so every element is compared
+    report_ops("find Deque iterators", n, [&]{ keep(std::find(deq.cbegin(), deq.cend(), T(-1)) - deq.cbegin()); });
+    report_ops("find Deque segments", n, [&]{ keep(find(deq, T(-1))); });
+    report_ops("find Vector", n, [&]{ keep(std::find(vec.data(), vec.data() + vec.size(), T(-1)) - vec.data()); });
+}
+
+void bench_scan(const std::size_t n){
+    std::printf("== scans over %zu elements ==\n", n);
+    scan_type<int>("int", n);
+    scan_type<float>("float", n);
+}
+
+
+struct Benchmark{
+    const char* name;
+    void (*run)(std::size_t);
+    std::size_t default_elements;
+};
+
+constexpr Benchmark benchmarks[] = {
+    {"push", bench_push, 1000000},
+    {"random", bench_random, 1000000},
+    {"fifo", bench_fifo, 1000000},
+    {"mixed", bench_mixed, 1000000},
+    {"scan", bench_scan, 1000000},
+};
+
+
+int main(int argc, char** argv){
+    const char* only = argc > 1 ? argv[1] : nullptr;
+    const std::size_t elements = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+
+    bool found = false;
+    for(const Benchmark& b : benchmarks){
+        if(only != nullptr && std::strcmp(only, b.name) != 0) continue;
+        found = true;
+        b.run(elements > 0 ? elements : b.default_elements);
+    }
+
+    if(!found){
+        std::fprintf(stderr, "Unknown benchmark %s\n", only);
+        return 1;
+    }
+    return 0;
+}
@@ -1,7 +1,382 @@
 #define BOOST_TEST_MODULE deque
 #include <boost/test/included/unit_test.hpp>
 #include "Deque.hpp"
+#include <deque>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
 
-BOOST_AUTO_TEST_CASE(tmp){
-    BOOST_TEST(true);
+
+BOOST_AUTO_TEST_CASE(push_back_ints){
+    Deque<int> deq;
+    BOOST_TEST(deq.empty());
+
+    // Fill several blocks
+    constexpr int expected_size = 5000;
+    for(int i = 0; i < expected_size; ++i){
+        deq.push_back(i);
+    }
+
+    BOOST_TEST(deq.size() == 5000);
+    BOOST_TEST(deq.front() == 0);
+    BOOST_TEST(deq.back() == expected_size - 1);
+    for(int i = 0; i < expected_size; ++i){
+        BOOST_TEST(deq.at(static_cast<std::size_t>(i)) == i);
+        BOOST_TEST(deq[static_cast<std::size_t>(i)] == i);
+    }
+    BOOST_CHECK_THROW(static_cast<void>(deq.at(5000)), std::out_of_range);
+}
+
+
+BOOST_AUTO_TEST_CASE(push_front_ints){
+    Deque<int> deq;
+
+    constexpr int expected_size = 5000;
+    for(int i = 0; i < expected_size; ++i){
+        deq.push_front(i);
+    }
+
+    BOOST_TEST(deq.size() == 5000);
+    BOOST_TEST(deq.front() == expected_size - 1);
+    BOOST_TEST(deq.back() == 0);
+    for(int i = 0; i < expected_size; ++i){
+        BOOST_TEST(deq[static_cast<std::size_t>(i)] == expected_size - 1 - i);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(empty_access){
+    Deque<int> deq;
+    BOOST_CHECK_THROW(static_cast<void>(deq.at(0)), std::out_of_range);
+    BOOST_CHECK_THROW(static_cast<void>(deq.front()), std::out_of_range);
+    BOOST_CHECK_THROW(static_cast<void>(deq.back()), std::out_of_range);
+    BOOST_CHECK_THROW(static_cast<void>(deq.begin()), std::out_of_range);
+    BOOST_CHECK_THROW(static_cast<void>(deq.cend()), std::out_of_range);
+}
+
+
+// Mixed pushes at both ends must index like std::deque for any block size
+template<class D>
+void check_against_std(){
+    D deq;
+    std::deque<int> expected;
+    unsigned x = 12345;
+    for(int i = 0; i < 3000; ++i){
+        x = x * 1103515245u + 12345u;
+        if((x >> 16) & 1){
+            deq.push_back(i);
+            expected.push_back(i);
+        }else{
+            deq.emplace_front(i);
+            expected.emplace_front(i);
+        }
+    }
+
+    BOOST_TEST(deq.size() == expected.size());
+    for(std::size_t i = 0; i < expected.size(); ++i){
+        BOOST_TEST(deq[i] == expected[i]);
+    }
+    BOOST_TEST(std::equal(deq.cbegin(), deq.cend(), expected.begin(), expected.end()));
+}
+
+
+BOOST_AUTO_TEST_CASE(block_sizes){
+    BOOST_TEST(Deque<char>::BLOCKSIZE == 4096);
+    BOOST_TEST(Deque<int>::BLOCKSIZE == 1024);
+    BOOST_TEST((Deque<std::array<char, 24>>::BLOCKSIZE == 128));
+    BOOST_TEST((Deque<std::array<char, 8192>>::BLOCKSIZE == 1));
+    BOOST_TEST((Deque<int, 16>::BLOCK_SHIFT == 4));
+    BOOST_TEST((Deque<int, 16>::BLOCK_MASK == 15));
+
+    check_against_std<Deque<int>>();
+    check_against_std<Deque<int, 1>>();
+    check_against_std<Deque<int, 2>>();
+    check_against_std<Deque<int, 16>>();
+    check_against_std<Deque<int, 64>>();
+}
+
+
+BOOST_AUTO_TEST_CASE(iterators){
+    Deque<int, 8> deq;
+    for(int i = 0; i < 100; ++i){
+        deq.push_back(99 - i);
+        deq.push_front(i - 100);
+    }
+
+    // Random access across blocks in both directions
+    auto it = deq.begin();
+    BOOST_TEST((deq.end() - it == 200));
+    BOOST_TEST(*(it + 37) == deq[37]);
+    BOOST_TEST(it[150] == deq[150]);
+    auto last = deq.end() - 1;
+    BOOST_TEST(*last == deq.back());
+    BOOST_TEST(*(last - 123) == deq[76]);
+    BOOST_TEST((it < last));
+    BOOST_TEST(((it + 200) == deq.end()));
+
+    std::size_t count = 0;
+    for(auto i = deq.end(); i != deq.begin(); ++count) --i;
+    BOOST_TEST(count == 200);
+
+    // Works with the standard algorithms
+    std::sort(deq.begin(), deq.end());
+    BOOST_TEST(std::is_sorted(deq.cbegin(), deq.cend()));
+    BOOST_TEST(deq.front() == -100);
+    BOOST_TEST(deq.back() == 99);
+    BOOST_TEST(std::accumulate(deq.cbegin(), deq.cend(), 0) == -100);
+}
+
+
+BOOST_AUTO_TEST_CASE(strings){
+    Deque<std::string> deq;
+    for(int i = 0; i < 1000; ++i){
+        deq.push_back(std::to_string(i));
+        deq.emplace_front(3, 'a');
+    }
+
+    BOOST_TEST(deq.size() == 2000);
+    BOOST_TEST(deq.front() == "aaa");
+    BOOST_TEST(deq.back() == "999");
+    BOOST_TEST(deq[1000] == "0");
+
+    deq[0] += "b";
+    BOOST_TEST(deq.front() == "aaab");
+}
+
+
+// Counts live objects, so the tests can see every constructed element is destroyed exactly once
+struct Tracked{
+    static inline int live = 0;
+    int value;
+
+    explicit Tracked(const int _value) : value{_value} { ++live; }
+    Tracked(const Tracked& other) : value{other.value} { ++live; }
+    Tracked& operator=(const Tracked&) = default;
+    ~Tracked(){ --live; }
+};
+
+
+BOOST_AUTO_TEST_CASE(element_lifetimes){
+    {
+        // Tracked has no default constructor, so no unused slot can have been constructed
+        Deque<Tracked, 4> deq;
+        for(int i = 0; i < 50; ++i){
+            deq.emplace_back(i);
+            deq.emplace_front(-i);
+        }
+        BOOST_TEST(Tracked::live == 100);
+        BOOST_TEST(deq.front().value == -49);
+        BOOST_TEST(deq.back().value == 49);
+
+        Deque<Tracked, 4> copy(deq);
+        BOOST_TEST(Tracked::live == 200);
+        BOOST_TEST(copy[37].value == deq[37].value);
+
+        Deque<Tracked, 4> moved(std::move(copy));
+        BOOST_TEST(Tracked::live == 200);
+        BOOST_TEST(copy.empty());
+        BOOST_TEST(moved.size() == 100);
+
+        moved = deq;
+        BOOST_TEST(Tracked::live == 200);
+        deq = std::move(moved);
+        BOOST_TEST(Tracked::live == 100);
+        BOOST_TEST(deq[99].value == 49);
+    }
+    BOOST_TEST(Tracked::live == 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(overaligned){
+    struct alignas(64) Line{
+        int value;
+    };
+
+    Deque<Line> deq;
+    for(int i = 0; i < 300; ++i){
+        deq.push_front(Line{i});
+    }
+    for(std::size_t i = 0; i < deq.size(); ++i){
+        BOOST_TEST(reinterpret_cast<std::uintptr_t>(&deq[i]) % 64 == 0);
+        BOOST_TEST(deq[i].value == 299 - static_cast<int>(i));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(pop_both_ends){
+    Deque<int, 4> deq;
+    std::deque<int> expected;
+    BOOST_CHECK_THROW(deq.pop_front(), std::out_of_range);
+    BOOST_CHECK_THROW(deq.pop_back(), std::out_of_range);
+
+    // Random pushes and pops at both ends, the deque empties several times
+    unsigned x = 777;
+    for(int i = 0; i < 20000; ++i){
+        x = x * 1103515245u + 12345u;
+        switch((x >> 16) % 4){
+        case 0:
+            deq.push_back(i);
+            expected.push_back(i);
+            break;
+        case 1:
+            deq.push_front(i);
+            expected.push_front(i);
+            break;
+        case 2:
+            if(!expected.empty()){
+                deq.pop_back();
+                expected.pop_back();
+            }
+            break;
+        default:
+            if(!expected.empty()){
+                deq.pop_front();
+                expected.pop_front();
+            }
+        }
+        BOOST_REQUIRE(deq.size() == expected.size());
+        if(!expected.empty()){
+            BOOST_REQUIRE(deq.front() == expected.front());
+            BOOST_REQUIRE(deq.back() == expected.back());
+        }
+    }
+    BOOST_TEST(std::equal(deq.cbegin(), deq.cend(), expected.begin(), expected.end()));
+    BOOST_TEST((deq.spare_blocks() <= Deque<int, 4>::SPARE_BLOCKS));
+}
+
+
+BOOST_AUTO_TEST_CASE(spare_blocks){
+    Deque<Tracked, 4, 3> deq;
+    for(int i = 0; i < 20; ++i) deq.emplace_back(i);
+
+    // A FIFO at a steady size keeps one emptied block to refill
+    for(int i = 20; i < 200; ++i){
+        deq.pop_front();
+        deq.emplace_back(i);
+        BOOST_REQUIRE(deq.front().value == i - 19);
+    }
+    BOOST_TEST(deq.spare_blocks() <= 1);
+    BOOST_TEST(deq.capacity() <= 4 * deq.size());
+    BOOST_TEST(Tracked::live == 20);
+
+    // Emptying keeps at most SpareBlocks blocks
+    while(!deq.empty()) deq.pop_back();
+    BOOST_TEST(deq.spare_blocks() == 3);
+    BOOST_TEST(Tracked::live == 0);
+
+    for(int i = 0; i < 10; ++i) deq.emplace_front(i);
+    deq.clear();
+    BOOST_TEST(deq.empty());
+    BOOST_TEST(Tracked::live == 0);
+
+    deq.shrink_to_fit();
+    BOOST_TEST(deq.spare_blocks() == 0);
+    BOOST_TEST(deq.capacity() == 0);
+
+    // A deque without spares frees every emptied block
+    Deque<int, 4, 0> none;
+    for(int i = 0; i < 100; ++i) none.push_back(i);
+    for(int i = 0; i < 50; ++i) none.pop_front();
+    BOOST_TEST(none.spare_blocks() == 0);
+    none.shrink_to_fit();
+    BOOST_TEST(none.capacity() == 52);
+    BOOST_TEST(none.front() == 50);
+    BOOST_TEST(none[49] == 99);
+}
+
+
+BOOST_AUTO_TEST_CASE(map_growth_both_ends){
+    // One element per block, so every push needs a new map slot
+    Deque<int, 1> deq;
+    std::deque<int> expected;
+    for(int i = 0; i < 5000; ++i){
+        if(i % 2 == 0){
+            deq.push_back(i);
+            expected.push_back(i);
+        }else{
+            deq.push_front(i);
+            expected.push_front(i);
+        }
+    }
+    BOOST_TEST(std::equal(deq.cbegin(), deq.cend(), expected.begin(), expected.end()));
+
+    // The map grows geometrically no matter which end needs the room
+    BOOST_TEST(deq.capacity() <= 4 * deq.size());
+
+    // A FIFO drifting towards the back recenters in place once the map has slack instead of growing it
+    for(int i = 0; i < 100000; ++i){
+        deq.pop_front();
+        deq.push_back(i);
+        expected.pop_front();
+        expected.push_back(i);
+    }
+    const std::size_t capacity = deq.capacity();
+    BOOST_TEST(capacity <= 4 * deq.size());
+    BOOST_TEST(std::equal(deq.cbegin(), deq.cend(), expected.begin(), expected.end()));
+
+    // Same towards the front
+    for(int i = 0; i < 100000; ++i){
+        deq.pop_back();
+        deq.push_front(i);
+        expected.pop_back();
+        expected.push_front(i);
+    }
+    BOOST_TEST(deq.capacity() == capacity);
+    BOOST_TEST(std::equal(deq.cbegin(), deq.cend(), expected.begin(), expected.end()));
+}
+
+
+BOOST_AUTO_TEST_CASE(segments){
+    Deque<int, 8> deq;
+    BOOST_TEST(deq.segment_count() == 0);
+    BOOST_TEST(deq.segment(0).empty());
+    BOOST_TEST(find(deq, 1) == 0);
+    BOOST_TEST(accumulate(deq, 5) == 5);
+
+    // Partly filled blocks at both ends
+    std::deque<int> expected;
+    for(int i = 0; i < 50; ++i){
+        deq.push_back(i);
+        expected.push_back(i);
+    }
+    for(int i = 0; i < 13; ++i){
+        deq.push_front(-i);
+        expected.push_front(-i);
+    }
+
+    // The segments cover every element once, in order
+    std::vector<int> seen;
+    deq.for_each_segment([&](const std::span<int> seg){
+        BOOST_TEST(!seg.empty());
+        BOOST_TEST(seg.size() <= 8);
+        seen.insert(seen.end(), seg.begin(), seg.end());
+    });
+    BOOST_TEST(std::equal(seen.begin(), seen.end(), expected.begin(), expected.end()));
+    BOOST_TEST(deq.segment(deq.segment_count()).empty());
+
+    std::vector<int> copied(deq.size());
+    BOOST_TEST((copy(deq, copied.begin()) == copied.end()));
+    BOOST_TEST(std::equal(copied.begin(), copied.end(), expected.begin(), expected.end()));
+
+    BOOST_TEST(find(deq, 0) == 12);
+    BOOST_TEST(find(deq, 49) == deq.size() - 1);
+    BOOST_TEST(find(deq, 1000) == deq.size());
+
+    BOOST_TEST(accumulate(deq, 0) == std::accumulate(expected.begin(), expected.end(), 0));
+    BOOST_TEST(accumulate(deq, std::int64_t(1), [](std::int64_t a, int b){ return a + 2 * b; })
+        == std::accumulate(expected.begin(), expected.end(), std::int64_t(1), [](std::int64_t a, int b){ return a + 2 * b; }));
+
+    std::vector<long> squares;
+    transform(deq, std::back_inserter(squares), [](int x){ return long(x) * x; });
+    BOOST_TEST(squares.size() == deq.size());
+    for(std::size_t i = 0; i < squares.size(); ++i) BOOST_TEST(squares[i] == long(expected[i]) * expected[i]);
+
+    transform(deq, [](int x){ return x + 1; });
+    for(std::size_t i = 0; i < deq.size(); ++i) BOOST_TEST(deq[i] == expected[i] + 1);
+
+    fill(deq, 7);
+    BOOST_TEST(std::all_of(deq.cbegin(), deq.cend(), [](int x){ return x == 7; }));
+    BOOST_TEST(deq.size() == expected.size());
 }
@@ -0,0 +1,404 @@
+#ifndef BIT_VECTOR_HPP
+#define BIT_VECTOR_HPP
+
+#include "Vector.hpp"
+#include "Vector_Kernels.hpp"
+#include <algorithm>
+#include <bit>
+
+
+// A vector of bits packed 64 to a word
+// Whole vectors combine a word at a time with SIMD, and rank and select are answered from a small sampled index
+// The bits past size() in the last word are always zero, so the words can be counted and compared directly
+class BitVector{
+public:
+    typedef std::size_t size_type;
+    typedef std::uint64_t word_type;
+
+    // Bits in a storage word
+    static constexpr size_type WORD_BITS = 64;
+
+    // Words per rank block, the rank index stores one count per 512 bits
+    static constexpr size_type BLOCK_WORDS = 8;
+
+    // The select index stores the block of every SELECT_SAMPLE-th set bit
+    static constexpr size_type SELECT_SAMPLE = 4096;
+
+private:
+
+    Vector<word_type> Words;            // The bits, bit i is bit i % 64 of word i / 64
+    size_type Bits;                     // The number of bits in the vector
+    mutable Vector<size_type> Ranks;    // Ranks[b] is the number of set bits before block b, plus the total at the end
+    mutable Vector<size_type> Samples;  // Samples[j] is the block holding set bit j * SELECT_SAMPLE
+    mutable bool Indexed;               // True while Ranks and Samples describe the current bits
+
+
+    // Returns the number of words holding _size bits
+    [[nodiscard]] static constexpr size_type words_for(const size_type _size) noexcept {
+        return (_size + WORD_BITS - 1) / WORD_BITS;
+    }
+
+
+    // Returns the bits of the last word that are in use, all ones when the last word is full
+    [[nodiscard]] word_type tail_mask() const noexcept {
+        return Bits % WORD_BITS == 0 ? ~word_type(0) : (word_type(1) << (Bits % WORD_BITS)) - 1;
+    }
+
+
+    // Clears the bits past size() in the last word
+    void clear_tail() noexcept {
+        if(!Words.empty()) Words.back() &= tail_mask();
+    }
+
+
+    // Throws std::out_of_range when bit i does not exist
+    void check(const size_type i) const {
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+    }
+
+
+    // Throws std::invalid_argument when other holds a different number of bits
+    void check_same_size(const BitVector& other) const {
+        if(size() != other.size()) throw std::invalid_argument("BitVectors must have the same size");
+    }
+
+
+    // Combines every word of other into the matching word of this vector with op, at the fastest SIMD level
+    template<class Op>
+    void combine(const BitVector& other, Op op){
+        check_same_size(other);
+        word_type* dst = Words.data();
+        const word_type* src = other.Words.data();
+        const size_type n = Words.size();
+        simd_detail::dispatch(simd_level(), [=]() __attribute__((always_inline)) {
+            for(size_type i = 0; i < n; ++i) dst[i] = op(dst[i], src[i]);
+        });
+        Indexed = false;
+    }
+
+
+    // Returns the index of the set bit with rank r in word w, which has more than r set bits
+    // Skips whole bytes first, then clears the lower set bits of the byte holding it
+    [[nodiscard]] static size_type select_in_word(word_type w, size_type r) noexcept {
+        size_type shift = 0;
+        for(size_type in_byte; r >= (in_byte = simd_detail::popcount_word(w & 0xff)); shift += 8){
+            r -= in_byte;
+            w >>= 8;
+        }
+        for(; r > 0; --r) w &= w - 1;
+        return shift + static_cast<size_type>(std::countr_zero(w));
+    }
+
+public:
+
+    // Default constructor
+    BitVector() noexcept :
+    Bits{0}, Indexed{false} {}
+
+
+    // Size constructor, every bit is set to value
+    explicit BitVector(const size_type _size, const bool value = false) :
+    BitVector() {
+        resize(_size, value);
+    }
+
+
+    // Initializer list constructor
+    BitVector(std::initializer_list<bool> list) :
+    BitVector() {
+        reserve(list.size());
+        for(const bool bit : list){
+            push_back(bit);
+        }
+    }
+
+
+    // Adds a bit to the back of the vector
+    void push_back(const bool bit){
+        if(Bits % WORD_BITS == 0) Words.push_back(0);
+        Words.back() |= word_type(bit) << (Bits % WORD_BITS);
+        ++Bits;
+        Indexed = false;
+    }
+
+
+    // Removes the last bit
+    void pop_back(){
+        if(empty()) throw std::out_of_range("Cannot remove element from empty vector");
+        --Bits;
+        if(Bits % WORD_BITS == 0) Words.pop_back();
+        else clear_tail();
+        Indexed = false;
+    }
+
+
+    // Returns bit i without checking the index
+    [[nodiscard]] bool operator[](const size_type i) const noexcept {
+        return (Words[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+    }
+
+
+    // Returns bit i
+    // Throws std::out_of_range when i >= size()
+    [[nodiscard]] bool test(const size_type i) const {
+        check(i);
+        return (*this)[i];
+    }
+
+
+    // Sets bit i to value
+    // Throws std::out_of_range when i >= size()
+    void set(const size_type i, const bool value = true){
+        check(i);
+        const word_type mask = word_type(1) << (i % WORD_BITS);
+        Words[i / WORD_BITS] = value ? Words[i / WORD_BITS] | mask : Words[i / WORD_BITS] & ~mask;
+        Indexed = false;
+    }
+
+
+    // Clears bit i
+    // Throws std::out_of_range when i >= size()
+    void reset(const size_type i){
+        set(i, false);
+    }
+
+
+    // Inverts bit i
+    // Throws std::out_of_range when i >= size()
+    void flip(const size_type i){
+        check(i);
+        Words[i / WORD_BITS] ^= word_type(1) << (i % WORD_BITS);
+        Indexed = false;
+    }
+
+
+    // Sets every bit
+    void set() noexcept {
+        std::fill(Words.data(), Words.data() + Words.size(), ~word_type(0));
+        clear_tail();
+        Indexed = false;
+    }
+
+
+    // Clears every bit
+    void reset() noexcept {
+        std::fill(Words.data(), Words.data() + Words.size(), word_type(0));
+        Indexed = false;
+    }
+
+
+    // Inverts every bit
+    void flip() noexcept {
+        for(size_type i = 0; i < Words.size(); ++i) Words[i] = ~Words[i];
+        clear_tail();
+        Indexed = false;
+    }
+
+
+    // Returns the number of set bits, counted with the SIMD popcount kernel
+    [[nodiscard]] size_type count() const {
+        return simd_popcount(Words);
+    }
+
+
+    // Returns true if any bit is set
+    [[nodiscard]] bool any() const {
+        return std::any_of(Words.data(), Words.data() + Words.size(), [](const word_type w){ return w != 0; });
+    }
+
+
+    // Returns true if no bit is set
+    [[nodiscard]] bool none() const {
+        return !any();
+    }
+
+
+    // Returns true if every bit is set
+    [[nodiscard]] bool all() const {
+        return count() == size();
+    }
+
+
+    // Keeps the bits set in both vectors
+    // Throws std::invalid_argument when the sizes differ
+    BitVector& operator&=(const BitVector& other){
+        combine(other, [](const word_type a, const word_type b){ return a & b; });
+        return *this;
+    }
+
+
+    // Keeps the bits set in either vector
+    // Throws std::invalid_argument when the sizes differ
+    BitVector& operator|=(const BitVector& other){
+        combine(other, [](const word_type a, const word_type b){ return a | b; });
+        return *this;
+    }
+
+
+    // Keeps the bits set in exactly one of the vectors
+    // Throws std::invalid_argument when the sizes differ
+    BitVector& operator^=(const BitVector& other){
+        combine(other, [](const word_type a, const word_type b){ return a ^ b; });
+        return *this;
+    }
+
+
+    // Clears the bits set in other, this & ~other
+    // Throws std::invalid_argument when the sizes differ
+    BitVector& and_not(const BitVector& other){
+        combine(other, [](const word_type a, const word_type b){ return a & ~b; });
+        return *this;
+    }
+
+
+    // Binary operators, returning a new vector
+    [[nodiscard]] friend BitVector operator&(BitVector left, const BitVector& right){
+        return left &= right;
+    }
+    [[nodiscard]] friend BitVector operator|(BitVector left, const BitVector& right){
+        return left |= right;
+    }
+    [[nodiscard]] friend BitVector operator^(BitVector left, const BitVector& right){
+        return left ^= right;
+    }
+    [[nodiscard]] friend BitVector operator~(BitVector vec){
+        vec.flip();
+        return vec;
+    }
+
+
+    // Vectors are equal when they hold the same bits
+    [[nodiscard]] friend bool operator==(const BitVector& left, const BitVector& right){
+        return left.size() == right.size() && simd_equal(left.Words, right.Words);
+    }
+
+
+    // Builds the rank and select index, which rank() and select() otherwise build on first use after a change
+    // Call it before sharing a vector between threads, since the lazy build writes to the vector
+    void build_index() const {
+        if(Indexed) return;
+
+        const size_type blocks = Words.size() / BLOCK_WORDS + 1;
+        Ranks.resize(blocks + 1);
+        Samples.clear();
+        size_type total = 0;
+        for(size_type b = 0; b < blocks; ++b){
+            Ranks[b] = total;
+            const size_type first = b * BLOCK_WORDS;
+            const size_type in_block = simd_detail::popcount(Words.data() + first, std::min(BLOCK_WORDS, Words.size() - first));
+            for(size_type next = Samples.size() * SELECT_SAMPLE; next < total + in_block; next += SELECT_SAMPLE){
+                Samples.push_back(b);
+            }
+            total += in_block;
+        }
+        Ranks[blocks] = total;
+        Indexed = true;
+    }
+
+
+    // Returns the number of set bits before bit i, O(1) from the rank index
+    // Throws std::out_of_range when i > size()
+    [[nodiscard]] size_type rank(const size_type i) const {
+        if(i > size()) throw std::out_of_range("Indexed out of range");
+        build_index();
+
+        const size_type word = i / WORD_BITS;
+        const size_type first = word / BLOCK_WORDS * BLOCK_WORDS;
+        size_type total = Ranks[word / BLOCK_WORDS] + simd_detail::popcount(Words.data() + first, word - first);
+        if(i % WORD_BITS != 0) total += simd_detail::popcount_word(Words[word] & ((word_type(1) << (i % WORD_BITS)) - 1));
+        return total;
+    }
+
+
+    // Returns the index of the set bit with rank r, the (r + 1)-th set bit
+    // The select samples narrow the search to a few blocks, which are binary searched by their ranks
+    // Throws std::out_of_range when fewer than r + 1 bits are set
+    [[nodiscard]] size_type select(const size_type r) const {
+        build_index();
+        if(r >= Ranks.back()) throw std::out_of_range("Fewer set bits than the requested rank");
+
+        const size_type sample = r / SELECT_SAMPLE;
+        const size_type lo = Samples[sample];
+        const size_type hi = sample + 1 < Samples.size() ? Samples[sample + 1] + 1 : Ranks.size() - 1;
+        const size_type b = static_cast<size_type>(std::upper_bound(Ranks.data() + lo, Ranks.data() + hi, r) - Ranks.data()) - 1;
+
+        size_type remaining = r - Ranks[b];
+        for(size_type w = b * BLOCK_WORDS;; ++w){
+            const size_type in_word = simd_detail::popcount_word(Words[w]);
+            if(remaining < in_word) return w * WORD_BITS + select_in_word(Words[w], remaining);
+            remaining -= in_word;
+        }
+    }
+
+
+    // Returns the number of bits
+    [[nodiscard]] size_type size() const noexcept {
+        return Bits;
+    }
+
+
+    // Returns true if the vector holds no bits
+    [[nodiscard]] bool empty() const noexcept {
+        return Bits == 0;
+    }
+
+
+    // Returns the number of bits that fit before the words are reallocated
+    [[nodiscard]] size_type capacity() const noexcept {
+        return Words.capacity() * WORD_BITS;
+    }
+
+
+    // Resizes the vector to _size bits, new bits are set to value
+    void resize(const size_type _size, const bool value = false){
+        if(_size < size()){
+            Words.resize(words_for(_size));
+            Bits = _size;
+            clear_tail();
+        }else if(_size > size()){
+            // Fill the unused bits of the last word, then whole words
+            if(value && Bits % WORD_BITS != 0) Words.back() |= ~tail_mask();
+            Words.resize(words_for(_size));
+            if(value) std::fill(Words.data() + words_for(Bits), Words.data() + Words.size(), ~word_type(0));
+            Bits = _size;
+            clear_tail();
+        }
+        Indexed = false;
+    }
+
+
+    // Allocates space for at least _size bits
+    void reserve(const size_type _size){
+        Words.reserve(words_for(_size));
+    }
+
+
+    // Removes every bit
+    void clear() noexcept {
+        Words.clear();
+        Bits = 0;
+        Indexed = false;
+    }
+
+
+    // Shrinks the words and the index to fit
+    void shrink_to_fit(){
+        Words.shrink_to_fit();
+        Ranks.shrink_to_fit();
+        Samples.shrink_to_fit();
+    }
+
+
+    // Returns the storage words, bit i is bit i % 64 of word i / 64
+    [[nodiscard]] const Vector<word_type>& words() const noexcept {
+        return Words;
+    }
+
+
+    // Returns a pointer to the storage words
+    [[nodiscard]] const word_type* data() const noexcept {
+        return Words.data();
+    }
+};
+
+#endif
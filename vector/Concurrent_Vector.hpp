@@ -0,0 +1,257 @@
+#ifndef CONCURRENT_VECTOR_HPP
+#define CONCURRENT_VECTOR_HPP
+
+#include "Vector.hpp"
+#include "Index_Iterator.hpp"
+#include "Geometric_Segments.hpp"
+#include <atomic>
+
+
+// An append-only vector that many threads can push_back into while others read earlier elements
+// Elements live in segments that double in size and are never moved, so references stay valid
+// Segment s holds FIRST_SEGMENT << s elements, index i is found with one bit scan of i + FIRST_SEGMENT
+template<class T>
+class ConcurrentVector{
+public:
+    typedef std::size_t size_type;
+
+    // Elements in the first segment, a power of two
+    static constexpr size_type FIRST_SEGMENT = 16;
+
+private:
+
+    typedef Geometric_Segments<FIRST_SEGMENT> Layout;
+
+    // Every segment is one block: the elements followed by one ready flag per element
+    static constexpr size_type ALIGNMENT = alignof(T) > alignof(std::atomic<bool>) ? alignof(T) : alignof(std::atomic<bool>);
+
+    std::atomic<size_type> Size;                        // Number of slots handed out, including elements still being constructed
+    std::atomic<unsigned char*> segments[Layout::COUNT]; // The segment blocks, allocated on first use
+
+
+    // Returns the element slots of a segment block
+    [[nodiscard]] static T* elements(unsigned char* block) noexcept {
+        return reinterpret_cast<T*>(block);
+    }
+
+
+    // Returns the ready flags of a segment block of segment s
+    [[nodiscard]] static std::atomic<bool>* flags(unsigned char* block, const size_type s) noexcept {
+        return reinterpret_cast<std::atomic<bool>*>(block + Layout::size_of(s) * sizeof(T));
+    }
+
+
+    // Returns the block of segment s, allocating it if no thread has yet
+    // Racing threads each allocate, the first to publish wins and the others free theirs
+    unsigned char* segment(const size_type s){
+        unsigned char* block = segments[s].load(std::memory_order_acquire);
+        if(block != nullptr) return block;
+
+        const size_type n = Layout::size_of(s);
+        unsigned char* fresh = static_cast<unsigned char*>(::operator new(n * (sizeof(T) + sizeof(std::atomic<bool>)), std::align_val_t(ALIGNMENT)));
+        std::atomic<bool>* ready = flags(fresh, s);
+        for(size_type i = 0; i < n; ++i){
+            new (ready + i) std::atomic<bool>(false);
+        }
+
+        if(segments[s].compare_exchange_strong(block, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) return fresh;
+        ::operator delete(static_cast<void*>(fresh), std::align_val_t(ALIGNMENT));
+        return block;
+    }
+
+
+    // Destroys every constructed element and frees every segment
+    void release() noexcept {
+        const size_type count = Size.load(std::memory_order_relaxed);
+        for(size_type s = 0; s < Layout::COUNT; ++s){
+            unsigned char* block = segments[s].load(std::memory_order_relaxed);
+            if(block == nullptr) continue;
+
+            const size_type first = Layout::start_of(s);
+            for(size_type i = 0; i < Layout::size_of(s) && first + i < count; ++i){
+                if(flags(block, s)[i].load(std::memory_order_relaxed)) std::destroy_at(elements(block) + i);
+            }
+            ::operator delete(static_cast<void*>(block), std::align_val_t(ALIGNMENT));
+            segments[s].store(nullptr, std::memory_order_relaxed);
+        }
+        Size.store(0, std::memory_order_relaxed);
+    }
+
+protected:
+
+    template<class Access_Type>
+    using IteratorType = Index_Iterator<std::conditional_t<std::is_const_v<Access_Type>, const ConcurrentVector, ConcurrentVector>, Access_Type>;
+
+public:
+
+    // STL compliant iterator allowing mutable elements
+    // Only valid while no thread is adding elements
+    typedef IteratorType<T> iterator;
+
+    // STL compliant const iterator ensuring elements cannot be changed
+    // Only valid while no thread is adding elements
+    typedef IteratorType<const T> const_iterator;
+
+
+    // Default constructor
+    ConcurrentVector() noexcept :
+    Size{0} {
+        for(size_type s = 0; s < Layout::COUNT; ++s){
+            segments[s].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+
+    // Elements are shared between threads by address, so ConcurrentVector can be neither copied nor moved
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+
+    // Constructs an element at the back and returns its index, safe to call from many threads at once
+    // Claims the slot with one atomic increment, so threads never wait on each other
+    // If the constructor throws, the slot stays claimed but is never ready
+    template<class... Args>
+    size_type emplace_back(Args&&... args){
+        const size_type i = Size.fetch_add(1, std::memory_order_relaxed);
+        const size_type s = Layout::segment_of(i);
+        unsigned char* block = segment(s);
+        std::construct_at(elements(block) + Layout::offset_of(i), std::forward<Args>(args)...);
+        flags(block, s)[Layout::offset_of(i)].store(true, std::memory_order_release);
+        return i;
+    }
+
+
+    // Copies the given element to the back of the vector and returns its index
+    size_type push_back(const T& elt){
+        return emplace_back(elt);
+    }
+
+
+    // Moves the given element to the back of the vector and returns its index
+    size_type push_back(T&& elt){
+        return emplace_back(std::move(elt));
+    }
+
+
+    // Allocates the segments for the first _size elements, safe to call while other threads add elements
+    void reserve(const size_type _size){
+        if(_size == 0) return;
+        for(size_type s = 0; s <= Layout::segment_of(_size - 1); ++s){
+            static_cast<void>(segment(s));
+        }
+    }
+
+
+    // Returns the number of slots handed out
+    // Includes elements other threads are still constructing, check ready() before reading those
+    [[nodiscard]] size_type size() const noexcept {
+        return Size.load(std::memory_order_acquire);
+    }
+
+
+    // Returns true if no element has been added
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+
+    // Returns the number of elements the allocated segments can hold
+    // Concurrent growers may allocate a later segment before an earlier one, so every segment is counted
+    [[nodiscard]] size_type capacity() const noexcept {
+        size_type total = 0;
+        for(size_type s = 0; s < Layout::COUNT; ++s){
+            if(segments[s].load(std::memory_order_acquire) != nullptr) total += Layout::size_of(s);
+        }
+        return total;
+    }
+
+
+    // Returns true once the element at index i is constructed and visible to this thread
+    [[nodiscard]] bool ready(const size_type i) const noexcept {
+        if(i >= size()) return false;
+        unsigned char* block = segments[Layout::segment_of(i)].load(std::memory_order_acquire);
+        return block != nullptr && flags(block, Layout::segment_of(i))[Layout::offset_of(i)].load(std::memory_order_acquire);
+    }
+
+
+    // Returns a reference to the indexed element
+    // Throws std::out_of_range unless the element is ready
+    [[nodiscard]] T& at(const size_type i){
+        if(!ready(i)) throw std::out_of_range("Indexed out of range");
+        return (*this)[i];
+    }
+
+
+    // Returns a const reference to the indexed element
+    // Throws std::out_of_range unless the element is ready
+    [[nodiscard]] const T& at(const size_type i) const {
+        if(!ready(i)) throw std::out_of_range("Indexed out of range");
+        return (*this)[i];
+    }
+
+
+    // Operator overload to allow direct indexing
+    // The element must be ready, for example because this thread added it or checked ready()
+    [[nodiscard]] T& operator[](const size_type i) noexcept {
+        return elements(segments[Layout::segment_of(i)].load(std::memory_order_acquire))[Layout::offset_of(i)];
+    }
+
+
+    // Operator overload to allow direct const indexing
+    [[nodiscard]] const T& operator[](const size_type i) const noexcept {
+        return elements(segments[Layout::segment_of(i)].load(std::memory_order_acquire))[Layout::offset_of(i)];
+    }
+
+
+    // Returns an iterator to the first element
+    [[nodiscard]] iterator begin(){
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty ConcurrentVector");
+        return iterator(this, 0);
+    }
+
+
+    // Returns an iterator one past the last element
+    [[nodiscard]] iterator end(){
+        return begin() + size();
+    }
+
+
+    // Returns a const iterator to the first element
+    [[nodiscard]] const_iterator cbegin() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty ConcurrentVector");
+        return const_iterator(this, 0);
+    }
+
+
+    // Returns a const iterator one past the last element
+    [[nodiscard]] const_iterator cend() const {
+        return cbegin() + size();
+    }
+
+
+    // Returns a const iterator to the first element
+    [[nodiscard]] const_iterator begin() const {
+        return cbegin();
+    }
+
+
+    // Returns a const iterator one past the last element
+    [[nodiscard]] const_iterator end() const {
+        return cend();
+    }
+
+
+    // Destroys every element and frees every segment
+    // Not safe while other threads use the vector
+    void clear() noexcept {
+        release();
+    }
+
+
+    // Destructor
+    ~ConcurrentVector(){
+        release();
+    }
+};
+
+#endif
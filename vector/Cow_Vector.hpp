@@ -0,0 +1,371 @@
+#ifndef COW_VECTOR_HPP
+#define COW_VECTOR_HPP
+
+#include "Vector.hpp"
+#include <atomic>
+
+
+// A Vector whose copies share one buffer until one of them is changed
+// Copying only bumps an atomic reference count, the first mutation of a shared buffer copies it
+// Reads through const members never copy, so read-only snapshots cost one pointer and one increment
+// Once a mutable reference, pointer or iterator is handed out, copies take a deep copy until the buffer is reallocated or cleared
+template<class T, class Allocator = std::allocator<T>>
+class CowVector{
+public:
+    typedef std::size_t size_type;
+    typedef Allocator allocator_type;
+    typedef typename Vector<T, Allocator>::iterator iterator;
+    typedef typename Vector<T, Allocator>::const_iterator const_iterator;
+
+private:
+
+    // The shared buffer and the number of CowVectors using it
+    struct Shared{
+        std::atomic<size_type> refs;
+        Vector<T, Allocator> elts;
+
+        explicit Shared(Vector<T, Allocator>&& _elts) noexcept :
+        refs{1}, elts{std::move(_elts)} {}
+    };
+
+    Shared* block;      // The buffer, nullptr while the vector is empty and owns nothing
+    bool unshareable;   // A mutable reference, pointer or iterator into block was handed out, so copies must not share it
+
+
+    // Drops this vector's reference, freeing the buffer when it was the last one
+    void release() noexcept {
+        if(block != nullptr && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete block;
+        block = nullptr;
+    }
+
+
+    // Makes this vector the only user of its buffer, copying the buffer if it is shared, and returns the elements
+    // The acquire pairs with the release of other owners letting go, so their reads finish before this vector writes
+    Vector<T, Allocator>& unique_elts(){
+        if(block == nullptr){
+            block = new Shared(Vector<T, Allocator>());
+        }else if(block->refs.load(std::memory_order_acquire) != 1){
+            Shared* copy = new Shared(Vector<T, Allocator>(block->elts));
+            release();
+            block = copy;
+        }
+        return block->elts;
+    }
+
+
+    // Returns this vector's own elements for a caller that hands out mutable access to them
+    // The buffer stays private from then on, a later copy sharing it would see writes through that access
+    Vector<T, Allocator>& leak_elts(){
+        Vector<T, Allocator>& elts = unique_elts();
+        unshareable = true;
+        return elts;
+    }
+
+
+    // Runs f on this vector's own elements
+    // If f moved the elements to a new buffer every handed out reference is invalid, so the buffer can be shared again
+    template<class F>
+    void mutate(F&& f){
+        Vector<T, Allocator>& elts = unique_elts();
+        const T* const before = elts.data();
+        f(elts);
+        if(elts.data() != before) unshareable = false;
+    }
+
+
+    // Returns a buffer for a copy of other: other's own when it can be shared, otherwise a deep copy
+    static Shared* share(const CowVector& other){
+        if(other.block == nullptr) return nullptr;
+        if(other.unshareable) return new Shared(Vector<T, Allocator>(other.block->elts));
+        other.block->refs.fetch_add(1, std::memory_order_relaxed);
+        return other.block;
+    }
+
+public:
+
+    // Default constructor
+    CowVector() noexcept :
+    block{nullptr}, unshareable{false} {}
+
+
+    // Size constructor with default values
+    explicit CowVector(const size_type _size, const Allocator& _alloc = Allocator()) :
+    CowVector(Vector<T, Allocator>(_size, _alloc)) {}
+
+
+    // Size constructor with given value
+    CowVector(const size_type _size, const T& elt, const Allocator& _alloc = Allocator()) :
+    CowVector(Vector<T, Allocator>(_size, elt, _alloc)) {}
+
+
+    // Initializer list constructor
+    CowVector(std::initializer_list<T> list, const Allocator& _alloc = Allocator()) :
+    CowVector(Vector<T, Allocator>(list, _alloc)) {}
+
+
+    // Takes over the elements of a Vector without copying them
+    explicit CowVector(Vector<T, Allocator>&& elts) :
+    block{new Shared(std::move(elts))}, unshareable{false} {}
+
+
+    // Copy constructor
+    // Shares other's buffer, nothing is copied until one of the two is changed
+    // Copies the buffer right away if other handed out mutable access to it
+    CowVector(const CowVector& other) :
+    block{share(other)}, unshareable{false} {}
+
+
+    // Move constructor
+    // Handed out references move with the buffer, so the buffer stays private
+    CowVector(CowVector&& other) noexcept :
+    block{std::exchange(other.block, nullptr)}, unshareable{std::exchange(other.unshareable, false)} {}
+
+
+    // Copy assignment
+    CowVector& operator=(const CowVector& other){
+        // Guard self assignment
+        if(this == &other) return *this;
+
+        Shared* const shared_block = share(other);
+        release();
+        block = shared_block;
+        unshareable = false;
+        return *this;
+    }
+
+
+    // Move assignment
+    CowVector& operator=(CowVector&& other) noexcept {
+        // Guard self assignment
+        if(this == &other) return *this;
+
+        release();
+        block = std::exchange(other.block, nullptr);
+        unshareable = std::exchange(other.unshareable, false);
+        return *this;
+    }
+
+
+    // Returns the number of CowVectors sharing this buffer, 0 when the vector owns no buffer
+    [[nodiscard]] size_type use_count() const noexcept {
+        return block == nullptr ? 0 : block->refs.load(std::memory_order_acquire);
+    }
+
+
+    // Returns true if another CowVector shares this buffer, so the next mutation copies it
+    [[nodiscard]] bool shared() const noexcept {
+        return use_count() > 1;
+    }
+
+
+    // Adds the given element in place in memory
+    template<class... Args>
+    void emplace_back(Args&&... args){
+        mutate([&](Vector<T, Allocator>& elts){ elts.emplace_back(std::forward<Args>(args)...); });
+    }
+
+
+    // Adds the given const element to the back of the vector
+    void push_back(const T& elt){
+        mutate([&](Vector<T, Allocator>& elts){ elts.push_back(elt); });
+    }
+
+
+    // Adds the given element to the back of the vector in place
+    void push_back(T&& elt){
+        mutate([&](Vector<T, Allocator>& elts){ elts.push_back(std::move(elt)); });
+    }
+
+
+    // Inserts elt before index pos
+    void insert(const size_type pos, const T& elt){
+        mutate([&](Vector<T, Allocator>& elts){ elts.insert(pos, elt); });
+    }
+
+
+    // Removes the elements at indices [first, last)
+    void erase(const size_type first, const size_type last){
+        unique_elts().erase(first, last);
+    }
+
+
+    // Removes the element at index pos
+    void erase(const size_type pos){
+        unique_elts().erase(pos);
+    }
+
+
+    // Removes the last element in the vector
+    void pop_back(){
+        if(empty()) throw std::out_of_range("Cannot remove element from empty vector");
+        unique_elts().pop_back();
+    }
+
+
+    // Returns the size of the vector
+    [[nodiscard]] size_type size() const noexcept {
+        return block == nullptr ? 0 : block->elts.size();
+    }
+
+
+    // Returns the capacity of the buffer
+    [[nodiscard]] size_type capacity() const noexcept {
+        return block == nullptr ? 0 : block->elts.capacity();
+    }
+
+
+    // Returns true if the vector is empty
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+
+    // Returns a reference to the indexed element
+    // Copies the buffer if it is shared
+    [[nodiscard]] T& at(const size_type i){
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return leak_elts()[i];
+    }
+
+
+    // Returns a const reference to the indexed element, never copies
+    [[nodiscard]] const T& at(const size_type i) const {
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return block->elts[i];
+    }
+
+
+    // Returns a reference to the first element in the vector
+    // Copies the buffer if it is shared
+    [[nodiscard]] T& front(){
+        return at(0);
+    }
+
+
+    // Returns a const reference to the first element in the vector
+    [[nodiscard]] const T& front() const {
+        return at(0);
+    }
+
+
+    // Returns a reference to the final element in the vector
+    // Copies the buffer if it is shared
+    [[nodiscard]] T& back(){
+        if(size() == 0) throw std::out_of_range("Indexed out of range");
+        return at(size() - 1);
+    }
+
+
+    // Returns a const reference to the final element in the vector
+    [[nodiscard]] const T& back() const {
+        if(size() == 0) throw std::out_of_range("Indexed out of range");
+        return at(size() - 1);
+    }
+
+
+    // Operator overload to allow direct indexing
+    // Copies the buffer if it is shared, read through a const CowVector to avoid that
+    [[nodiscard]] T& operator[](const size_type i){
+        return leak_elts()[i];
+    }
+
+
+    // Operator overload to allow direct const indexing, never copies
+    [[nodiscard]] const T& operator[](const size_type i) const noexcept {
+        return block->elts[i];
+    }
+
+
+    // Returns a pointer to the elements for writing
+    // Copies the buffer if it is shared
+    [[nodiscard]] T* data(){
+        return leak_elts().data();
+    }
+
+
+    // Returns a pointer to the elements for reading, never copies
+    [[nodiscard]] const T* data() const noexcept {
+        return block == nullptr ? nullptr : block->elts.data();
+    }
+
+
+    // Returns an iterator to the first element in the vector
+    // Copies the buffer if it is shared
+    [[nodiscard]] iterator begin(){
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty CowVector");
+        return leak_elts().begin();
+    }
+
+
+    // Returns an iterator one element past the last element in the vector
+    // Copies the buffer if it is shared
+    [[nodiscard]] iterator end(){
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty CowVector");
+        return leak_elts().end();
+    }
+
+
+    // Returns a const iterator to the first element in the vector, never copies
+    [[nodiscard]] const_iterator cbegin() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty CowVector");
+        return block->elts.cbegin();
+    }
+
+
+    // Returns a const iterator one element past the last element in the vector, never copies
+    [[nodiscard]] const_iterator cend() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty CowVector");
+        return block->elts.cend();
+    }
+
+
+    // Returns a const iterator to the first element in the vector, never copies
+    [[nodiscard]] const_iterator begin() const {
+        return cbegin();
+    }
+
+
+    // Returns a const iterator one element past the last element in the vector, never copies
+    [[nodiscard]] const_iterator end() const {
+        return cend();
+    }
+
+
+    // Clear the vector
+    // A shared buffer is left to the other vectors instead of being copied and cleared
+    // Every handed out reference is invalidated, so the buffer can be shared again
+    void clear() noexcept {
+        if(shared()) release();
+        else if(block != nullptr) block->elts.clear();
+        unshareable = false;
+    }
+
+
+    // Shrinks the buffer to the number of elements
+    // Copies the buffer if it is shared
+    void shrink_to_fit(){
+        if(block != nullptr) mutate([](Vector<T, Allocator>& elts){ elts.shrink_to_fit(); });
+    }
+
+
+    // Allocates space for at least _size elements
+    // Copies the buffer if it is shared
+    void reserve(const size_type _size){
+        mutate([&](Vector<T, Allocator>& elts){ elts.reserve(_size); });
+    }
+
+
+    // Resizes the vector to _size elements
+    // Fills empty space with default values, copies the buffer if it is shared
+    void resize(const size_type _size){
+        mutate([&](Vector<T, Allocator>& elts){ elts.resize(_size); });
+    }
+
+
+    // Destructor
+    ~CowVector(){
+        release();
+    }
+};
+
+#endif
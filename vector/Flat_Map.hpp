@@ -0,0 +1,310 @@
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include "Flat_Set.hpp"
+#include "Soa_Vector.hpp"
+#include <utility>
+
+
+// A sorted map with unique keys, stored as one Vector of keys and a parallel Vector of values
+// Lookups binary search the keys alone, so the values never pollute the cache while searching
+// Single inserts and erases shift the entries after them, so it suits tables that are read far more than written
+template<class K, class V, class Compare = std::less<K>>
+class FlatMap{
+public:
+    typedef std::size_t size_type;
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef Compare key_compare;
+private:
+
+    Vector<K> Keys;     // The keys in ascending order without duplicates
+    Vector<V> Values;   // Values[i] belongs to Keys[i]
+    Compare comp;       // Orders the keys
+
+
+    // Fills the map from unsorted pairs, keeping the first value of every duplicate key
+    void build(Vector<std::pair<K, V>>& pairs){
+        std::stable_sort(pairs.data(), pairs.data() + pairs.size(), [this](const auto& a, const auto& b){ return comp(a.first, b.first); });
+        Keys.reserve(pairs.size());
+        Values.reserve(pairs.size());
+        for(size_type i = 0; i < pairs.size(); ++i){
+            if(!Keys.empty() && !comp(Keys.back(), pairs[i].first)) continue;
+            Keys.push_back(std::move(pairs[i].first));
+            Values.push_back(std::move(pairs[i].second));
+        }
+    }
+
+
+    // Adds key at index i with a value built from args
+    // If the value cannot be added the key is taken out again, so Keys and Values never differ in size
+    template<class... Args>
+    void emplace_at(const size_type i, const K& key, Args&&... args){
+        Keys.insert(i, key);
+        try{
+            Values.emplace(i, std::forward<Args>(args)...);
+        }catch(...){
+            Keys.erase(i);
+            throw;
+        }
+    }
+
+public:
+
+    // Iterators yield tuples of references, the key is always const so the order cannot be broken
+    typedef Soa_Iterator<const K, V> iterator;
+    typedef Soa_Iterator<const K, const V> const_iterator;
+
+
+    // Default constructor
+    explicit FlatMap(const Compare& _comp = Compare()) :
+    comp{_comp} {}
+
+
+    // Builds the map from unsorted key value pairs, which may repeat keys
+    // Sorts once and drops duplicates in a single pass, the first pair of every key wins
+    template<class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+    FlatMap(InputIt first, InputIt last, const Compare& _comp = Compare()) :
+    comp{_comp} {
+        Vector<std::pair<K, V>> pairs;
+        pairs.append(first, last);
+        build(pairs);
+    }
+
+
+    // Builds the map from an unsorted list of key value pairs
+    FlatMap(std::initializer_list<std::pair<K, V>> list, const Compare& _comp = Compare()) :
+    FlatMap(list.begin(), list.end(), _comp) {}
+
+
+    // Returns the index of the first key not less than key
+    [[nodiscard]] size_type lower_bound(const K& key) const {
+        return branchless_lower_bound(Keys.data(), Keys.size(), key, comp);
+    }
+
+
+    // Returns the index of key, or size() if it is not in the map
+    [[nodiscard]] size_type find(const K& key) const {
+        const size_type i = lower_bound(key);
+        return i < size() && !comp(key, Keys[i]) ? i : size();
+    }
+
+
+    // Returns true if key is in the map
+    [[nodiscard]] bool contains(const K& key) const {
+        return find(key) != size();
+    }
+
+
+    // Returns 1 if key is in the map, 0 otherwise
+    [[nodiscard]] size_type count(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+
+    // Returns a reference to the value of key
+    // Throws std::out_of_range if key is not in the map
+    [[nodiscard]] V& at(const K& key){
+        const size_type i = find(key);
+        if(i == size()) throw std::out_of_range("Key is not in the map");
+        return Values[i];
+    }
+
+
+    // Returns a const reference to the value of key
+    // Throws std::out_of_range if key is not in the map
+    [[nodiscard]] const V& at(const K& key) const {
+        const size_type i = find(key);
+        if(i == size()) throw std::out_of_range("Key is not in the map");
+        return Values[i];
+    }
+
+
+    // Returns a reference to the value of key, inserting a default value if key is not in the map
+    V& operator[](const K& key){
+        const size_type i = lower_bound(key);
+        if(i == size() || comp(key, Keys[i])) emplace_at(i, key);
+        return Values[i];
+    }
+
+
+    // Adds key with value if key is not in the map yet, an existing value is kept
+    // Returns true if it was added
+    bool insert(const K& key, const V& value){
+        const size_type i = lower_bound(key);
+        if(i < size() && !comp(key, Keys[i])) return false;
+        emplace_at(i, key, value);
+        return true;
+    }
+
+
+    // Sets the value of key, adding key if it is not in the map yet
+    // Returns true if it was added
+    bool insert_or_assign(const K& key, const V& value){
+        const size_type i = lower_bound(key);
+        if(i < size() && !comp(key, Keys[i])){
+            Values[i] = value;
+            return false;
+        }
+        emplace_at(i, key, value);
+        return true;
+    }
+
+
+    // Adds every pair in [first, last) whose key is not in the map yet, existing values are kept
+    // The batch is sorted and merged with the entries in one pass, O(n + m log m) instead of O(n * m) for m single inserts
+    template<class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+    void insert(InputIt first, InputIt last){
+        FlatMap batch(first, last, comp);
+        if(batch.empty()) return;
+
+        // Entries are only moved out when neither the key nor the value move can throw, otherwise both are copied
+        // A key moved out before a throwing value copy would leave the map broken, so both follow one rule
+        constexpr bool move_entries = std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>;
+        const auto take = [](auto& elt) -> decltype(auto) {
+            if constexpr(move_entries) return std::move(elt);
+            else return std::as_const(elt);
+        };
+
+        Vector<K> merged_keys;
+        Vector<V> merged_values;
+        merged_keys.reserve(size() + batch.size());
+        merged_values.reserve(size() + batch.size());
+        size_type i = 0;
+        size_type j = 0;
+        while(i < size() && j < batch.size()){
+            if(comp(batch.Keys[j], Keys[i])){
+                merged_keys.push_back(take(batch.Keys[j]));
+                merged_values.push_back(take(batch.Values[j++]));
+            }else{
+                if(!comp(Keys[i], batch.Keys[j])) ++j;  // Already in the map
+                merged_keys.push_back(take(Keys[i]));
+                merged_values.push_back(take(Values[i++]));
+            }
+        }
+        for(; i < size(); ++i){
+            merged_keys.push_back(take(Keys[i]));
+            merged_values.push_back(take(Values[i]));
+        }
+        for(; j < batch.size(); ++j){
+            merged_keys.push_back(take(batch.Keys[j]));
+            merged_values.push_back(take(batch.Values[j]));
+        }
+        Keys = std::move(merged_keys);
+        Values = std::move(merged_values);
+    }
+
+
+    // Adds every pair in the list whose key is not in the map yet
+    void insert(std::initializer_list<std::pair<K, V>> list){
+        insert(list.begin(), list.end());
+    }
+
+
+    // Removes key and its value from the map
+    // Returns true if it was in the map
+    bool erase(const K& key){
+        const size_type i = find(key);
+        if(i == size()) return false;
+        Keys.erase(i);
+        Values.erase(i);
+        return true;
+    }
+
+
+    // Returns the number of entries
+    [[nodiscard]] size_type size() const noexcept {
+        return Keys.size();
+    }
+
+
+    // Returns true if the map is empty
+    [[nodiscard]] bool empty() const noexcept {
+        return Keys.empty();
+    }
+
+
+    // Returns the sorted keys
+    [[nodiscard]] const Vector<K>& keys() const noexcept {
+        return Keys;
+    }
+
+
+    // Returns the values, in the order of keys()
+    [[nodiscard]] const Vector<V>& values() const noexcept {
+        return Values;
+    }
+
+
+    // Returns the value at index i, in the order of keys()
+    [[nodiscard]] V& value(const size_type i) noexcept {
+        return Values[i];
+    }
+
+
+    // Returns the const value at index i, in the order of keys()
+    [[nodiscard]] const V& value(const size_type i) const noexcept {
+        return Values[i];
+    }
+
+
+    // Returns an iterator to the entry with the smallest key
+    [[nodiscard]] iterator begin(){
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty FlatMap");
+        return iterator(std::tuple<const K*, V*>(Keys.data(), Values.data()), 0);
+    }
+
+
+    // Returns an iterator one past the entry with the largest key
+    [[nodiscard]] iterator end(){
+        return begin() + size();
+    }
+
+
+    // Returns a const iterator to the entry with the smallest key
+    [[nodiscard]] const_iterator cbegin() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty FlatMap");
+        return const_iterator(std::tuple<const K*, const V*>(Keys.data(), Values.data()), 0);
+    }
+
+
+    // Returns a const iterator one past the entry with the largest key
+    [[nodiscard]] const_iterator cend() const {
+        return cbegin() + size();
+    }
+
+
+    // Returns a const iterator to the entry with the smallest key
+    [[nodiscard]] const_iterator begin() const {
+        return cbegin();
+    }
+
+
+    // Returns a const iterator one past the entry with the largest key
+    [[nodiscard]] const_iterator end() const {
+        return cend();
+    }
+
+
+    // Removes every entry
+    void clear() noexcept {
+        Keys.clear();
+        Values.clear();
+    }
+
+
+    // Allocates space for at least _size entries
+    void reserve(const size_type _size){
+        Keys.reserve(_size);
+        Values.reserve(_size);
+    }
+
+
+    // Shrinks both arrays to the number of entries
+    void shrink_to_fit(){
+        Keys.shrink_to_fit();
+        Values.shrink_to_fit();
+    }
+};
+
+#endif
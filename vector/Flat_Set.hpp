@@ -0,0 +1,221 @@
+#ifndef FLAT_SET_HPP
+#define FLAT_SET_HPP
+
+#include "Vector.hpp"
+#include <functional>
+
+
+// Returns the index of the first of the n sorted keys at first that does not compare less than key
+// The loop has a fixed trip count of log2(n) and the compare feeds a conditional move instead of a branch,
+// so a lookup never pays for a mispredicted branch
+template<class K, class Compare>
+[[nodiscard]] std::size_t branchless_lower_bound(const K* first, std::size_t n, const K& key, const Compare& comp){
+    if(n == 0) return 0;
+    const K* base = first;
+    while(n > 1){
+        const std::size_t half = n / 2;
+        base = comp(base[half], key) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<std::size_t>(base - first) + comp(*base, key);
+}
+
+
+// A sorted set of unique keys stored contiguously in a Vector
+// Lookups are a binary search over one array instead of a walk through separately allocated nodes
+// Single inserts and erases shift the keys after them, so it suits tables that are read far more than written
+template<class K, class Compare = std::less<K>>
+class FlatSet{
+public:
+    typedef std::size_t size_type;
+    typedef K key_type;
+    typedef Compare key_compare;
+private:
+
+    Vector<K> Keys;     // The keys in ascending order without duplicates
+    Compare comp;       // Orders the keys
+
+
+    // True when a and b are neither less than the other
+    [[nodiscard]] bool equivalent(const K& a, const K& b) const {
+        return !comp(a, b) && !comp(b, a);
+    }
+
+
+    // Sorts the keys and removes every duplicate but the first
+    void sort_unique(){
+        if(Keys.size() < 2) return;
+        K* first = Keys.data();
+        std::stable_sort(first, first + Keys.size(), comp);
+        K* last = std::unique(first, first + Keys.size(), [this](const K& a, const K& b){ return equivalent(a, b); });
+        Keys.erase(static_cast<size_type>(last - first), Keys.size());
+    }
+
+public:
+
+    // Keys cannot be changed in place, that could break the order
+    typedef typename Vector<K>::const_iterator const_iterator;
+    typedef const_iterator iterator;
+
+
+    // Default constructor
+    explicit FlatSet(const Compare& _comp = Compare()) :
+    comp{_comp} {}
+
+
+    // Builds the set from unsorted keys, which may hold duplicates
+    // Sorts once and removes duplicates in a single pass instead of inserting one key at a time
+    template<class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+    FlatSet(InputIt first, InputIt last, const Compare& _comp = Compare()) :
+    comp{_comp} {
+        Keys.append(first, last);
+        sort_unique();
+    }
+
+
+    // Builds the set from an unsorted list of keys
+    FlatSet(std::initializer_list<K> list, const Compare& _comp = Compare()) :
+    comp{_comp} {
+        Keys.append(list);
+        sort_unique();
+    }
+
+
+    // Builds the set from an unsorted Vector of keys, reusing its array
+    explicit FlatSet(Vector<K>&& unsorted, const Compare& _comp = Compare()) :
+    Keys{std::move(unsorted)}, comp{_comp} {
+        sort_unique();
+    }
+
+
+    // Returns the index of the first key not less than key
+    [[nodiscard]] size_type lower_bound(const K& key) const {
+        return branchless_lower_bound(Keys.data(), Keys.size(), key, comp);
+    }
+
+
+    // Returns the index of key, or size() if it is not in the set
+    [[nodiscard]] size_type find(const K& key) const {
+        const size_type i = lower_bound(key);
+        return i < size() && !comp(key, Keys[i]) ? i : size();
+    }
+
+
+    // Returns true if key is in the set
+    [[nodiscard]] bool contains(const K& key) const {
+        return find(key) != size();
+    }
+
+
+    // Returns 1 if key is in the set, 0 otherwise
+    [[nodiscard]] size_type count(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+
+    // Adds key if it is not in the set yet
+    // Returns true if it was added
+    bool insert(const K& key){
+        const size_type i = lower_bound(key);
+        if(i < size() && !comp(key, Keys[i])) return false;
+        Keys.insert(i, key);
+        return true;
+    }
+
+
+    // Adds every key in [first, last) that is not in the set yet
+    // The batch is sorted and merged with the keys in one pass, O(n + m log m) instead of O(n * m) for m single inserts
+    template<class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+    void insert(InputIt first, InputIt last){
+        FlatSet batch(first, last, comp);
+        if(batch.empty()) return;
+
+        // Keys are only moved out when that cannot throw, otherwise copied, so a throw leaves the set unchanged
+        Vector<K> merged;
+        merged.reserve(size() + batch.size());
+        size_type i = 0;
+        size_type j = 0;
+        while(i < size() && j < batch.size()){
+            if(comp(batch.Keys[j], Keys[i])) merged.push_back(std::move_if_noexcept(batch.Keys[j++]));
+            else{
+                if(!comp(Keys[i], batch.Keys[j])) ++j;  // Already in the set
+                merged.push_back(std::move_if_noexcept(Keys[i++]));
+            }
+        }
+        for(; i < size(); ++i) merged.push_back(std::move_if_noexcept(Keys[i]));
+        for(; j < batch.size(); ++j) merged.push_back(std::move_if_noexcept(batch.Keys[j]));
+        Keys = std::move(merged);
+    }
+
+
+    // Adds every key in the list that is not in the set yet
+    void insert(std::initializer_list<K> list){
+        insert(list.begin(), list.end());
+    }
+
+
+    // Removes key from the set
+    // Returns true if it was in the set
+    bool erase(const K& key){
+        const size_type i = find(key);
+        if(i == size()) return false;
+        Keys.erase(i);
+        return true;
+    }
+
+
+    // Returns the number of keys
+    [[nodiscard]] size_type size() const noexcept {
+        return Keys.size();
+    }
+
+
+    // Returns true if the set is empty
+    [[nodiscard]] bool empty() const noexcept {
+        return Keys.empty();
+    }
+
+
+    // Returns the key at index i in ascending order
+    [[nodiscard]] const K& operator[](const size_type i) const noexcept {
+        return Keys[i];
+    }
+
+
+    // Returns the sorted keys
+    [[nodiscard]] const Vector<K>& keys() const noexcept {
+        return Keys;
+    }
+
+
+    // Returns a const iterator to the smallest key
+    [[nodiscard]] const_iterator begin() const {
+        return Keys.cbegin();
+    }
+
+
+    // Returns a const iterator one past the largest key
+    [[nodiscard]] const_iterator end() const {
+        return Keys.cend();
+    }
+
+
+    // Removes every key
+    void clear() noexcept {
+        Keys.clear();
+    }
+
+
+    // Allocates space for at least _size keys
+    void reserve(const size_type _size){
+        Keys.reserve(_size);
+    }
+
+
+    // Shrinks the array to the number of keys
+    void shrink_to_fit(){
+        Keys.shrink_to_fit();
+    }
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef GEOMETRIC_SEGMENTS_HPP
+#define GEOMETRIC_SEGMENTS_HPP
+
+#include <bit>
+#include <cstddef>
+
+
+// Index math for storage split into segments that double in size
+// Segment s holds First << s elements and starts at index (First << s) - First
+// The segment of index i is one bit scan of i + First, so lookups never loop
+template<std::size_t First>
+struct Geometric_Segments{
+    static_assert(First > 0 && (First & (First - 1)) == 0, "The first segment must hold a power of two elements");
+
+    static constexpr std::size_t FIRST = First;
+    static constexpr std::size_t FIRST_BITS = static_cast<std::size_t>(std::countr_zero(First));
+
+    // Enough segments to address every std::size_t index
+    static constexpr std::size_t COUNT = sizeof(std::size_t) * 8 - FIRST_BITS;
+
+
+    // Returns the segment holding index i
+    // The or keeps the result below COUNT even for indices so large that i + First wraps
+    [[nodiscard]] static constexpr std::size_t segment_of(const std::size_t i) noexcept {
+        return static_cast<std::size_t>(std::bit_width((i + First) | First)) - 1 - FIRST_BITS;
+    }
+
+
+    // Returns the position of index i within its segment
+    [[nodiscard]] static constexpr std::size_t offset_of(const std::size_t i) noexcept {
+        return (i + First) ^ std::bit_floor((i + First) | First);
+    }
+
+
+    // Returns the number of elements in segment s
+    [[nodiscard]] static constexpr std::size_t size_of(const std::size_t s) noexcept {
+        return First << s;
+    }
+
+
+    // Returns the index of the first element of segment s
+    [[nodiscard]] static constexpr std::size_t start_of(const std::size_t s) noexcept {
+        return (First << s) - First;
+    }
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef HUGE_VECTOR_HPP
+#define HUGE_VECTOR_HPP
+
+#include "Vector.hpp"
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+// An allocator that maps anonymous memory straight from the kernel
+// reallocate() uses mremap, so growing a buffer remaps its pages instead of copying them
+// Mappings of at least HUGE_PAGE_SIZE bytes are advised to use transparent huge pages
+template<class T>
+struct Mmap_Allocator{
+    static constexpr std::size_t HUGE_PAGE_SIZE = std::size_t(2) << 20;
+
+    typedef T value_type;
+
+    constexpr Mmap_Allocator() noexcept = default;
+
+    template<class U>
+    constexpr Mmap_Allocator(const Mmap_Allocator<U>&) noexcept {}
+
+    // Returns the number of bytes mapped for n elements (a whole number of pages)
+    [[nodiscard]] static std::size_t mapped_size(const std::size_t n){
+        if(n > std::size_t(-1) / sizeof(T)) throw std::bad_array_new_length();
+        static const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        return (n * sizeof(T) + page - 1) / page * page;
+    }
+
+    // Maps uninitialized (zero filled) space for n elements
+    [[nodiscard]] T* allocate(const std::size_t n){
+        if(n == 0) return nullptr;
+        const std::size_t bytes = mapped_size(n);
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(p == MAP_FAILED) throw std::bad_alloc();
+        advise(p, bytes);
+        return static_cast<T*>(p);
+    }
+
+    // Unmaps space returned by allocate() or reallocate()
+    void deallocate(T* p, const std::size_t n) noexcept {
+        if(p != nullptr) munmap(static_cast<void*>(p), mapped_size(n));
+    }
+
+    // Resizes the mapping at p to new_n elements
+    // The kernel moves the page table entries when it cannot extend in place, the data is never copied
+    [[nodiscard]] T* reallocate(T* p, const std::size_t old_n, const std::size_t new_n){
+        if(p == nullptr) return allocate(new_n);
+        if(new_n == 0){
+            deallocate(p, old_n);
+            return nullptr;
+        }
+
+        const std::size_t old_bytes = mapped_size(old_n);
+        const std::size_t new_bytes = mapped_size(new_n);
+        if(old_bytes == new_bytes) return p;
+
+        void* temp = mremap(static_cast<void*>(p), old_bytes, new_bytes, MREMAP_MAYMOVE);
+        if(temp == MAP_FAILED) throw std::bad_alloc();
+        advise(temp, new_bytes);
+        return static_cast<T*>(temp);
+    }
+
+    friend constexpr bool operator==(const Mmap_Allocator&, const Mmap_Allocator&) noexcept { return true; }
+    friend constexpr bool operator!=(const Mmap_Allocator&, const Mmap_Allocator&) noexcept { return false; }
+
+private:
+
+    // Asks for transparent huge pages on large mappings, purely a hint
+    static void advise([[maybe_unused]] void* p, [[maybe_unused]] const std::size_t bytes) noexcept {
+#ifdef MADV_HUGEPAGE
+        if(bytes >= HUGE_PAGE_SIZE) madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    }
+};
+
+
+// A Vector for multi-gigabyte arrays, backed by Mmap_Allocator
+// Trivially relocatable elements grow through mremap, so growth never copies the data
+template<class T, class GrowthPolicy = Double_Growth>
+using HugeVector = Vector<T, Mmap_Allocator<T>, GrowthPolicy>;
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef INDEX_ITERATOR_HPP
+#define INDEX_ITERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+
+
+// Random access iterator over a container that is indexed but not contiguous
+// Holds the container and an index, and dereferences through the container's operator[]
+// Container is const for const iterators
+template<class Container, class Access_Type>
+class Index_Iterator{
+public:
+    // Iterator traits to make the iterator stl compliant
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_cv_t<Access_Type>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Access_Type*;
+    using reference = Access_Type&;
+
+
+protected:
+    Container* owner;   // The container being iterated
+    std::size_t idx;    // The index this iterator points to
+
+public:
+    // Iterator to index _idx of _owner
+    constexpr Index_Iterator(Container* _owner, const std::size_t _idx) noexcept :
+    owner{_owner}, idx{_idx} {}
+
+
+    // Dereference operator overload
+    [[nodiscard]] constexpr reference operator*() const noexcept {
+        return (*owner)[idx];
+    }
+
+
+    // Dereference operator overload
+    [[nodiscard]] constexpr pointer operator->() const noexcept {
+        return &(*owner)[idx];
+    }
+
+
+    // Access operator
+    [[nodiscard]] constexpr reference operator[](const std::size_t i) const noexcept {
+        return (*owner)[idx + i];
+    }
+
+
+    // Prefix increment
+    constexpr Index_Iterator& operator++() noexcept {
+        ++idx;
+        return *this;
+    }
+
+
+    // Postfix increment
+    constexpr Index_Iterator operator++(int) noexcept {
+        Index_Iterator temp(*this);
+        ++idx;
+        return temp;
+    }
+
+
+    // Prefix decrement
+    constexpr Index_Iterator& operator--() noexcept {
+        --idx;
+        return *this;
+    }
+
+
+    // Postfix decrement
+    constexpr Index_Iterator operator--(int) noexcept {
+        Index_Iterator temp(*this);
+        --idx;
+        return temp;
+    }
+
+
+    // Compound Assignments
+    constexpr Index_Iterator& operator+=(const std::size_t offset) noexcept {
+        idx += offset;
+        return *this;
+    }
+    constexpr Index_Iterator& operator-=(const std::size_t offset) noexcept {
+        idx -= offset;
+        return *this;
+    }
+
+
+    // Addition
+    [[nodiscard]] friend constexpr Index_Iterator operator+(Index_Iterator it, const std::size_t offset) noexcept {
+        return it += offset;
+    }
+    [[nodiscard]] friend constexpr Index_Iterator operator+(const std::size_t offset, Index_Iterator it) noexcept {
+        return it += offset;
+    }
+
+
+    // Subtraction
+    [[nodiscard]] friend constexpr Index_Iterator operator-(Index_Iterator it, const std::size_t offset) noexcept {
+        return it -= offset;
+    }
+
+
+    [[nodiscard]] constexpr difference_type operator-(const Index_Iterator& other) const noexcept {
+        return static_cast<difference_type>(idx) - static_cast<difference_type>(other.idx);
+    }
+
+
+    // Equality operator overload
+    // Iterators are equal when they point to the same index of the same container
+    [[nodiscard]] friend constexpr bool operator==(const Index_Iterator& left, const Index_Iterator& right) noexcept {
+        return left.idx == right.idx && left.owner == right.owner;
+    }
+
+
+    // Inequality operator overload
+    [[nodiscard]] friend constexpr bool operator!=(const Index_Iterator& left, const Index_Iterator& right) noexcept {
+        return !(left == right);
+    }
+
+
+    // Comparison operators
+    [[nodiscard]] constexpr bool operator<(const Index_Iterator& other) const noexcept {
+        return idx < other.idx;
+    }
+    [[nodiscard]] constexpr bool operator<=(const Index_Iterator& other) const noexcept {
+        return idx <= other.idx;
+    }
+    [[nodiscard]] constexpr bool operator>(const Index_Iterator& other) const noexcept {
+        return idx > other.idx;
+    }
+    [[nodiscard]] constexpr bool operator>=(const Index_Iterator& other) const noexcept {
+        return idx >= other.idx;
+    }
+};
+
+#endif
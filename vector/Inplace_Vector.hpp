@@ -0,0 +1,344 @@
+#ifndef INPLACE_VECTOR_HPP
+#define INPLACE_VECTOR_HPP
+
+#include "Vector.hpp"
+
+
+// A Vector with a fixed capacity of N elements stored entirely inside the object
+// Never allocates, and every operation can be used in a constant expression
+template<class T, std::size_t N>
+class InplaceVector{
+public:
+    typedef std::size_t size_type;
+private:
+
+    // Raw storage for the elements, only the first Size are alive
+    // A union so that no element is constructed until it is added
+    union Storage{
+        constexpr Storage() noexcept {}
+        constexpr ~Storage() {}
+
+        T elts[N == 0 ? 1 : N];
+    };
+
+    size_type Size;     // The Current number of elements in the vector
+    Storage storage;    // The inline array
+
+
+    // Destroys the elements in [first, last)
+    constexpr void destroy_range(const size_type first, const size_type last) noexcept {
+        for(size_type i = first; i < last; ++i){
+            std::destroy_at(storage.elts + i);
+        }
+    }
+
+protected:
+
+    template<class Access_Type>
+    using IteratorType = Vector_Iterator<Access_Type>;
+
+public:
+
+    // STL compliant iterator allowing mutable elements
+    typedef IteratorType<T> iterator;
+
+    // STL compliant const iterator ensuring elements cannot be changed
+    typedef IteratorType<const T> const_iterator;
+
+
+    // Default constructor
+    constexpr InplaceVector() noexcept :
+    Size{0} {}
+
+
+    // The constructors below delegate to the default constructor, so if an element constructor throws
+    // the destructor runs and destroys the elements built so far
+
+    // Size constructor with default value
+    // Throws std::out_of_range when _size > N
+    constexpr explicit InplaceVector(const size_type _size) :
+    InplaceVector() {
+        resize(_size);
+    }
+
+
+    // Size constructor with given value
+    // Throws std::out_of_range when _size > N
+    constexpr InplaceVector(const size_type _size, const T& elt) :
+    InplaceVector() {
+        if(_size > capacity()) throw std::out_of_range("Size exceeds the capacity of InplaceVector");
+        for(size_type _ = 0; _ < _size; ++_){
+            push_back(elt);
+        }
+    }
+
+
+    // Copy constructor
+    constexpr InplaceVector(const InplaceVector& other) :
+    InplaceVector() {
+        for(; Size < other.size(); ++Size){
+            std::construct_at(storage.elts + Size, other[Size]);
+        }
+    }
+
+
+    // Move constructor
+    // Moves each element, leaving other with moved-from elements
+    constexpr InplaceVector(InplaceVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) :
+    InplaceVector() {
+        for(; Size < other.size(); ++Size){
+            std::construct_at(storage.elts + Size, std::move(other[Size]));
+        }
+    }
+
+
+    // Copy assignment
+    constexpr InplaceVector& operator=(const InplaceVector& other){
+        // Guard self assignment
+        if(this == &other) return *this;
+
+        clear();
+        for(; Size < other.size(); ++Size){
+            std::construct_at(storage.elts + Size, other[Size]);
+        }
+        return *this;
+    }
+
+
+    // Move assignment
+    constexpr InplaceVector& operator=(InplaceVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        // Guard self assignment
+        if(this == &other) return *this;
+
+        clear();
+        for(; Size < other.size(); ++Size){
+            std::construct_at(storage.elts + Size, std::move(other[Size]));
+        }
+        return *this;
+    }
+
+
+    // Adds the given element in place in memory
+    // Returns nullptr instead of adding it when the vector is full
+    template<class... Args>
+    constexpr T* try_emplace_back(Args&&... args){
+        if(size() == capacity()) return nullptr;
+        T* elt = std::construct_at(storage.elts + size(), std::forward<Args>(args)...);
+        ++Size;
+        return elt;
+    }
+
+
+    // Adds the given const element to the back of the vector
+    // Returns nullptr instead of adding it when the vector is full
+    constexpr T* try_push_back(const T& elt){
+        return try_emplace_back(elt);
+    }
+
+
+    // Adds the given element to the back of the vector in place
+    // Returns nullptr instead of adding it when the vector is full
+    constexpr T* try_push_back(T&& elt){
+        return try_emplace_back(std::move(elt));
+    }
+
+
+    // Adds the given element in place in memory
+    // Throws std::out_of_range when the vector is full
+    template<class... Args>
+    constexpr void emplace_back(Args&&... args){
+        if(try_emplace_back(std::forward<Args>(args)...) == nullptr)
+            throw std::out_of_range("No space left in InplaceVector");
+    }
+
+
+    // Adds the given const element to the back of the vector
+    constexpr void push_back(const T& elt){
+        emplace_back(elt);
+    }
+
+
+    // Adds the given element to the back of the vector in place
+    constexpr void push_back(T&& elt){
+        emplace_back(std::move(elt));
+    }
+
+
+    // Returns the size of the vector
+    [[nodiscard]] constexpr size_type size() const noexcept {
+        return Size;
+    }
+
+
+    // Returns the fixed capacity of the vector
+    [[nodiscard]] static constexpr size_type capacity() noexcept {
+        return N;
+    }
+
+
+    // Returns true if the vector is empty
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        return Size == 0;
+    }
+
+
+    // Returns true if the vector is full
+    [[nodiscard]] constexpr bool full() const noexcept {
+        return Size == N;
+    }
+
+
+    // Returns a reference to the indexed element
+    [[nodiscard]] constexpr T& at(const size_type i){
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return storage.elts[i];
+    }
+
+
+    // Returns a const reference to the indexed element
+    [[nodiscard]] constexpr const T& at(const size_type i) const {
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return storage.elts[i];
+    }
+
+
+    // Returns a reference to the first element in the vector
+    [[nodiscard]] constexpr T& front(){
+        return at(0);
+    }
+
+
+    // Returns a const reference to the first element in the vector
+    [[nodiscard]] constexpr const T& front() const {
+        return at(0);
+    }
+
+
+    // Returns a reference to the final element in the vector
+    [[nodiscard]] constexpr T& back(){
+        if(size() == 0) throw std::out_of_range("Indexed out of range");
+        return at(size() - 1);
+    }
+
+
+    // Returns a const reference to the final element in the vector
+    [[nodiscard]] constexpr const T& back() const {
+        if(size() == 0) throw std::out_of_range("Indexed out of range");
+        return at(size() - 1);
+    }
+
+
+    // Operator overload to allow direct indexing
+    [[nodiscard]] constexpr T& operator[](const size_type i) noexcept {
+        return storage.elts[i];
+    }
+
+
+    // Operator overload to allow direct const indexing
+    [[nodiscard]] constexpr const T& operator[](const size_type i) const noexcept {
+        return storage.elts[i];
+    }
+
+
+    // Returns an iterator to the first element in the vector
+    [[nodiscard]] constexpr iterator begin(){
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty InplaceVector");
+        return iterator(storage.elts);
+    }
+
+
+    // Returns an iterator one element past the last element in the vector
+    [[nodiscard]] constexpr iterator end(){
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty InplaceVector");
+        return iterator(storage.elts + size());
+    }
+
+
+    // Returns a const iterator to the first element in the vector
+    [[nodiscard]] constexpr const_iterator begin() const {
+        return cbegin();
+    }
+
+
+    // Returns a const iterator one element past the last element in the vector
+    [[nodiscard]] constexpr const_iterator end() const {
+        return cend();
+    }
+
+
+    // Returns a const iterator to the first element in the vector
+    [[nodiscard]] constexpr const_iterator cbegin() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty InplaceVector");
+        return const_iterator(storage.elts);
+    }
+
+
+    // Returns a const iterator one element past the last element in the vector
+    [[nodiscard]] constexpr const_iterator cend() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty InplaceVector");
+        return const_iterator(storage.elts + size());
+    }
+
+
+    // Removes the last element in the vector
+    constexpr void pop_back(){
+        if(empty()) throw std::out_of_range("Cannot remove element from empty vector");
+        --Size;
+        std::destroy_at(storage.elts + size());
+    }
+
+
+    // Clear the vector
+    constexpr void clear() noexcept {
+        destroy_range(0, size());
+        Size = 0;
+    }
+
+
+    // Does nothing, the capacity is fixed
+    constexpr void shrink_to_fit() noexcept {}
+
+
+    // Checks that _size elements fit, the capacity is fixed
+    // Throws std::out_of_range when _size > N
+    constexpr void reserve(const size_type _size) const {
+        if(_size > capacity()) throw std::out_of_range("Size exceeds the capacity of InplaceVector");
+    }
+
+
+    // Resizes the vector to _size elements
+    // Fills empty space with default values
+    // Throws std::out_of_range when _size > N
+    constexpr void resize(const size_type _size){
+        reserve(_size);
+        if(_size < size()){
+            destroy_range(_size, size());
+            Size = _size;
+            return;
+        }
+        for(; Size < _size; ++Size){
+            std::construct_at(storage.elts + Size);
+        }
+    }
+
+
+    // Returns a pointer to the underlying array
+    // Assumes class invariants will not be invalidated.
+    [[nodiscard]] constexpr T* data() noexcept {
+        return storage.elts;
+    }
+
+
+    // Returns a const pointer to the underlying array
+    [[nodiscard]] constexpr const T* data() const noexcept {
+        return storage.elts;
+    }
+
+
+    // Destructor
+    constexpr ~InplaceVector(){
+        destroy_range(0, size());
+    }
+};
+
+#endif
@@ -0,0 +1,247 @@
+#ifndef MAPPED_VECTOR_HPP
+#define MAPPED_VECTOR_HPP
+
+#include "Vector.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// The header at the start of every MappedVector file
+// Elements follow at data_offset, stored in the native byte order of the writer
+struct Mapped_Header{
+    static constexpr char MAGIC[8] = {'M', 'A', 'P', 'V', 'E', 'C', '0', '1'};
+
+    char magic[8];              // Always MAGIC
+    std::uint64_t element_size; // sizeof(T) of the writer
+    std::uint64_t count;        // Number of elements
+    std::uint64_t alignment;    // alignof(T) of the writer
+    std::uint64_t data_offset;  // Offset of the first element from the start of the file, a multiple of alignment
+};
+
+
+// A read-only Vector whose elements live in a file mapped with mmap
+// Pages are only read from disk when they are first touched, so opening a table is O(1)
+template<class T>
+class MappedVector{
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be stored in a file");
+public:
+    typedef std::size_t size_type;
+private:
+
+    size_type Size;         // Number of elements in the file
+    const T* arr;           // The first element inside the mapping
+    void* mapping;          // The whole mapped file, including the header
+    size_type mapped_bytes; // Length of the mapping
+
+
+    // Returns the offset of the first element for a file of T
+    [[nodiscard]] static constexpr size_type data_offset() noexcept {
+        return (sizeof(Mapped_Header) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+
+    // Unmaps the file
+    void release() noexcept {
+        if(mapping != nullptr) munmap(mapping, mapped_bytes);
+        mapping = nullptr;
+        arr = nullptr;
+        Size = 0;
+        mapped_bytes = 0;
+    }
+
+protected:
+
+    template<class Access_Type>
+    using IteratorType = Vector_Iterator<Access_Type>;
+
+public:
+
+    // STL compliant const iterator, the elements cannot be changed
+    typedef IteratorType<const T> const_iterator;
+
+    // Every iterator of a read-only vector is a const_iterator
+    typedef const_iterator iterator;
+
+
+    // Default constructor
+    // Maps nothing
+    constexpr MappedVector() noexcept :
+    Size{0}, arr{nullptr}, mapping{nullptr}, mapped_bytes{0} {}
+
+
+    // Maps the file at path
+    // Throws std::runtime_error when the file cannot be mapped or was not written for T
+    explicit MappedVector(const char* path) :
+    MappedVector() {
+        const int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if(fd < 0) throw std::runtime_error("Cannot open MappedVector file");
+
+        struct stat info{};
+        // The header is padded to data_offset(), so a valid file is never shorter than that
+        if(fstat(fd, &info) != 0 || static_cast<size_type>(info.st_size) < data_offset()){
+            close(fd);
+            throw std::runtime_error("MappedVector file is too small for its header");
+        }
+
+        mapped_bytes = static_cast<size_type>(info.st_size);
+        mapping = mmap(nullptr, mapped_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(mapping == MAP_FAILED){
+            mapping = nullptr;
+            throw std::runtime_error("Cannot map MappedVector file");
+        }
+
+        Mapped_Header header;
+        std::memcpy(&header, mapping, sizeof(header));
+        const bool valid = std::memcmp(header.magic, Mapped_Header::MAGIC, sizeof(header.magic)) == 0
+                        && header.element_size == sizeof(T)
+                        && header.alignment == alignof(T)
+                        && header.data_offset == data_offset()
+                        && header.count <= (mapped_bytes - data_offset()) / sizeof(T);
+        if(!valid){
+            release();
+            throw std::runtime_error("File does not hold a MappedVector of this type");
+        }
+
+        Size = static_cast<size_type>(header.count);
+        arr = reinterpret_cast<const T*>(static_cast<const char*>(mapping) + data_offset());
+    }
+
+
+    // Writes count elements starting at elts to a MappedVector file at path
+    // Throws std::runtime_error when the file cannot be written
+    static void write(const char* path, const T* elts, const size_type count){
+        std::FILE* file = std::fopen(path, "wb");
+        if(file == nullptr) throw std::runtime_error("Cannot create MappedVector file");
+
+        Mapped_Header header{};
+        std::memcpy(header.magic, Mapped_Header::MAGIC, sizeof(header.magic));
+        header.element_size = sizeof(T);
+        header.count = count;
+        header.alignment = alignof(T);
+        header.data_offset = data_offset();
+
+        const char padding[alignof(T)] = {};
+        bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        written = written && std::fwrite(padding, 1, data_offset() - sizeof(header), file) == data_offset() - sizeof(header);
+        written = written && (count == 0 || std::fwrite(elts, sizeof(T), count, file) == count);
+        written = std::fclose(file) == 0 && written;
+        if(!written) throw std::runtime_error("Cannot write MappedVector file");
+    }
+
+
+    // Writes the elements of vec to a MappedVector file at path
+    template<class Allocator, class GrowthPolicy>
+    static void write(const char* path, const Vector<T, Allocator, GrowthPolicy>& vec){
+        write(path, vec.data(), vec.size());
+    }
+
+
+    // Copying would duplicate the mapping, so MappedVector is move-only
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+
+    // Move constructor
+    MappedVector(MappedVector&& other) noexcept :
+    Size{other.Size}, arr{other.arr}, mapping{other.mapping}, mapped_bytes{other.mapped_bytes} {
+        other.mapping = nullptr;
+        other.release();
+    }
+
+
+    // Move assignment
+    MappedVector& operator=(MappedVector&& other) noexcept {
+        // Guard self assignment
+        if(this == &other) return *this;
+
+        release();
+        std::swap(Size, other.Size);
+        std::swap(arr, other.arr);
+        std::swap(mapping, other.mapping);
+        std::swap(mapped_bytes, other.mapped_bytes);
+        return *this;
+    }
+
+
+    // Returns the size of the vector
+    [[nodiscard]] constexpr size_type size() const noexcept {
+        return Size;
+    }
+
+
+    // Returns true if the vector is empty
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        return Size == 0;
+    }
+
+
+    // Returns a const reference to the indexed element
+    [[nodiscard]] const T& at(const size_type i) const {
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return arr[i];
+    }
+
+
+    // Returns a const reference to the first element in the vector
+    [[nodiscard]] const T& front() const {
+        return at(0);
+    }
+
+
+    // Returns a const reference to the final element in the vector
+    [[nodiscard]] const T& back() const {
+        if(size() == 0) throw std::out_of_range("Indexed out of range");
+        return at(size() - 1);
+    }
+
+
+    // Operator overload to allow direct const indexing
+    [[nodiscard]] const T& operator[](const size_type i) const noexcept {
+        return arr[i];
+    }
+
+
+    // Returns a const iterator to the first element in the vector
+    [[nodiscard]] const_iterator begin() const {
+        return cbegin();
+    }
+
+
+    // Returns a const iterator one element past the last element in the vector
+    [[nodiscard]] const_iterator end() const {
+        return cend();
+    }
+
+
+    // Returns a const iterator to the first element in the vector
+    [[nodiscard]] const_iterator cbegin() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty MappedVector");
+        return const_iterator(arr);
+    }
+
+
+    // Returns a const iterator one element past the last element in the vector
+    [[nodiscard]] const_iterator cend() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty MappedVector");
+        return const_iterator(arr + size());
+    }
+
+
+    // Returns a pointer to the mapped elements
+    [[nodiscard]] const T* data() const noexcept {
+        return arr;
+    }
+
+
+    // Destructor, unmaps the file
+    ~MappedVector(){
+        release();
+    }
+};
+
+#endif
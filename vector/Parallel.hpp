@@ -0,0 +1,143 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include "Vector.hpp"
+#include "Thread_Pool.hpp"
+#include <concepts>
+#include <optional>
+
+
+// How a parallel algorithm splits its range across a Thread_Pool
+struct Parallel_Options{
+    std::size_t grain = 0;          // Elements per chunk, 0 picks DEFAULT_GRAIN_BYTES worth of elements
+    bool commutative = false;       // parallel_reduce may combine chunks out of index order, op must be commutative
+    Thread_Pool* pool = nullptr;    // The pool to run on, nullptr uses default_pool()
+
+    // Chunks of this many bytes stay in a core's L2 cache while they are processed
+    static constexpr std::size_t DEFAULT_GRAIN_BYTES = std::size_t(64) << 10;
+};
+
+
+// Any container with contiguous data() and size(), such as Vector, its relatives or a std::span
+template<class Range>
+concept Contiguous_Range = requires(Range& range){
+    { range.data() } -> std::convertible_to<const void*>;
+    { range.size() } -> std::convertible_to<std::size_t>;
+};
+
+
+namespace parallel_detail{
+
+    // Returns the number of elements in each chunk
+    template<class T>
+    [[nodiscard]] constexpr std::size_t grain(const Parallel_Options& options) noexcept {
+        if(options.grain > 0) return options.grain;
+        return sizeof(T) >= Parallel_Options::DEFAULT_GRAIN_BYTES ? 1 : Parallel_Options::DEFAULT_GRAIN_BYTES / sizeof(T);
+    }
+
+
+    [[nodiscard]] inline Thread_Pool& pool(const Parallel_Options& options){
+        return options.pool != nullptr ? *options.pool : default_pool();
+    }
+
+
+    // Calls f(first, last) on consecutive chunks of [0, n) spread across the pool
+    // f also receives the chunk index and the participant running it
+    template<class T, class F>
+    void for_chunks(const std::size_t n, const Parallel_Options& options, F&& f){
+        const std::size_t step = grain<T>(options);
+        const std::size_t chunks = n / step + (n % step != 0);
+        pool(options).run(chunks, [&](const std::size_t chunk, const std::size_t participant){
+            const std::size_t first = chunk * step;
+            f(first, std::min(n, first + step), chunk, participant);
+        });
+    }
+}
+
+
+// Calls f on every element of range
+template<Contiguous_Range Range, class F>
+void parallel_for_each(Range&& range, F f, const Parallel_Options& options = {}){
+    auto* elts = range.data();
+    parallel_detail::for_chunks<std::remove_pointer_t<decltype(elts)>>(range.size(), options,
+        [&](const std::size_t first, const std::size_t last, std::size_t, std::size_t){
+            for(std::size_t i = first; i < last; ++i) f(elts[i]);
+        });
+}
+
+
+// Sets every element of range to value
+template<Contiguous_Range Range, class T>
+void parallel_fill(Range&& range, const T& value, const Parallel_Options& options = {}){
+    auto* elts = range.data();
+    parallel_detail::for_chunks<std::remove_pointer_t<decltype(elts)>>(range.size(), options,
+        [&](const std::size_t first, const std::size_t last, std::size_t, std::size_t){
+            std::fill(elts + first, elts + last, value);
+        });
+}
+
+
+// Resizes out to the size of in and stores f(in[i]) in out[i]
+// New trivial elements of out are first written by the thread that computes them
+template<Contiguous_Range Range, class U, class Allocator, class GrowthPolicy, class F>
+void parallel_transform(const Range& in, Vector<U, Allocator, GrowthPolicy>& out, F f, const Parallel_Options& options = {}){
+    const auto* src = in.data();
+    out.resize_for_overwrite(in.size());
+    U* dst = out.data();
+    parallel_detail::for_chunks<std::remove_cv_t<std::remove_pointer_t<decltype(src)>>>(in.size(), options,
+        [&](const std::size_t first, const std::size_t last, std::size_t, std::size_t){
+            for(std::size_t i = first; i < last; ++i) dst[i] = f(src[i]);
+        });
+}
+
+
+// Resizes out to the size of in and copies every element of in into it
+template<Contiguous_Range Range, class U, class Allocator, class GrowthPolicy>
+void parallel_copy(const Range& in, Vector<U, Allocator, GrowthPolicy>& out, const Parallel_Options& options = {}){
+    const auto* src = in.data();
+    out.resize_for_overwrite(in.size());
+    U* dst = out.data();
+    parallel_detail::for_chunks<U>(in.size(), options,
+        [&](const std::size_t first, const std::size_t last, std::size_t, std::size_t){
+            std::copy(src + first, src + last, dst + first);
+        });
+}
+
+
+// Returns init combined with every element of range through op, which must be associative
+// The elements are grouped into the same chunks and the chunks are combined in index order on every run and
+// for every thread count, so op need not be commutative and floating point results are reproducible
+// With options.commutative each thread instead folds the chunks it happens to take, which are not adjacent,
+// and the threads are combined in thread order, saving the per chunk partials
+template<Contiguous_Range Range, class T, class Op>
+[[nodiscard]] T parallel_reduce(const Range& range, T init, Op op, const Parallel_Options& options = {}){
+    const auto* elts = range.data();
+    typedef std::remove_cv_t<std::remove_pointer_t<decltype(elts)>> value_type;
+    const std::size_t n = range.size();
+    if(n == 0) return init;
+
+    // Folds the chunk [first, last) starting from its first element, so op needs no identity value
+    const auto fold = [&](const std::size_t first, const std::size_t last){
+        T acc = static_cast<T>(elts[first]);
+        for(std::size_t i = first + 1; i < last; ++i) acc = op(std::move(acc), elts[i]);
+        return acc;
+    };
+
+    const std::size_t step = parallel_detail::grain<value_type>(options);
+    const std::size_t partial_count = options.commutative ? parallel_detail::pool(options).size() : n / step + (n % step != 0);
+    Vector<std::optional<T>> partials(partial_count);
+
+    parallel_detail::for_chunks<value_type>(n, options,
+        [&](const std::size_t first, const std::size_t last, const std::size_t chunk, const std::size_t participant){
+            std::optional<T>& partial = partials[options.commutative ? participant : chunk];
+            if(partial) partial = op(std::move(*partial), fold(first, last));
+            else partial = fold(first, last);
+        });
+
+    for(std::size_t i = 0; i < partials.size(); ++i){
+        if(partials[i]) init = op(std::move(init), std::move(*partials[i]));
+    }
+    return init;
+}
+
+#endif
@@ -0,0 +1,501 @@
+#ifndef PERSISTENT_VECTOR_HPP
+#define PERSISTENT_VECTOR_HPP
+
+#include "Vector.hpp"
+#include "Index_Iterator.hpp"
+#include <atomic>
+
+
+// A 32-way trie of reference counted nodes, shared between versions
+// Leaves hold 32 elements, branches hold 32 children, and the last 1 to 32 elements live in a separate tail leaf
+// A node is edited in place only when every node on the path to it has a single owner, otherwise the path is copied
+namespace persistent_detail{
+
+    constexpr std::size_t BITS = 5;
+    constexpr std::size_t WIDTH = std::size_t(1) << BITS;
+    constexpr std::size_t MASK = WIDTH - 1;
+
+
+    // Every node counts the parents and vectors pointing to it
+    struct Node{
+        std::atomic<std::size_t> refs{1};
+    };
+
+
+    struct Branch : Node{
+        Node* children[WIDTH] = {};
+    };
+
+
+    // Up to WIDTH elements, constructed in order
+    template<class T>
+    struct Leaf : Node{
+        std::size_t count = 0;
+        alignas(T) unsigned char storage[WIDTH * sizeof(T)];
+
+        [[nodiscard]] T* elts() noexcept {
+            return reinterpret_cast<T*>(storage);
+        }
+
+        [[nodiscard]] const T* elts() const noexcept {
+            return reinterpret_cast<const T*>(storage);
+        }
+
+        ~Leaf(){
+            std::destroy(elts(), elts() + count);
+        }
+    };
+
+
+    template<class T>
+    class Trie{
+    public:
+        typedef std::size_t size_type;
+
+    private:
+        size_type Size;     // The number of elements, including the tail
+        size_type Shift;    // BITS times the number of branch levels below the root
+        Branch* root;       // Holds every element before tail_offset(), nullptr while they all fit in the tail
+        Leaf<T>* tail;      // The last elements, nullptr while the trie is empty
+
+
+        static void retain(Node* node) noexcept {
+            if(node != nullptr) node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+
+        // Drops one reference to the node at level, freeing it and its subtree when that was the last one
+        // Leaves are level 0, their parents level BITS
+        static void release(Node* node, const size_type level) noexcept {
+            if(node == nullptr || node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+            if(level == 0){
+                delete static_cast<Leaf<T>*>(node);
+                return;
+            }
+            Branch* branch = static_cast<Branch*>(node);
+            for(Node* child : branch->children){
+                release(child, level - BITS);
+            }
+            delete branch;
+        }
+
+
+        // Returns a node this trie may change in place: node itself if nothing else uses it, otherwise a copy
+        // A copied branch shares its children, which now have a second owner and are copied in turn when written
+        static Branch* editable(Branch* node, const size_type level){
+            if(node->refs.load(std::memory_order_acquire) == 1) return node;
+            Branch* copy = new Branch;
+            for(size_type k = 0; k < WIDTH; ++k){
+                copy->children[k] = node->children[k];
+                retain(copy->children[k]);
+            }
+            release(node, level);
+            return copy;
+        }
+
+
+        static Leaf<T>* editable(Leaf<T>* node){
+            if(node->refs.load(std::memory_order_acquire) == 1) return node;
+            Leaf<T>* copy = new Leaf<T>;
+            try{
+                for(; copy->count < node->count; ++copy->count){
+                    std::construct_at(copy->elts() + copy->count, node->elts()[copy->count]);
+                }
+            }catch(...){
+                delete copy;
+                throw;
+            }
+            release(node, 0);
+            return copy;
+        }
+
+
+        // Returns a chain of new branches from level down to leaf
+        static Node* new_path(const size_type level, Leaf<T>* leaf){
+            if(level == 0) return leaf;
+            Branch* branch = new Branch;
+            branch->children[0] = new_path(level - BITS, leaf);
+            return branch;
+        }
+
+
+        // Hangs the full leaf at index tail_offset() below parent, which is at level
+        void push_leaf(Branch* parent, const size_type level, Leaf<T>* leaf){
+            const size_type k = ((Size - 1) >> level) & MASK;
+            if(level == BITS){
+                parent->children[k] = leaf;
+            }else if(parent->children[k] == nullptr){
+                parent->children[k] = new_path(level - BITS, leaf);
+            }else{
+                Branch* child = editable(static_cast<Branch*>(parent->children[k]), level - BITS);
+                parent->children[k] = child;
+                push_leaf(child, level - BITS, leaf);
+            }
+        }
+
+
+        // Moves the full tail into the trie, adding a root level when the trie is full
+        void push_tail(){
+            if(root == nullptr){
+                root = new Branch;
+                root->children[0] = tail;
+            }else if((Size >> BITS) > (size_type(1) << Shift)){
+                Branch* top = new Branch;
+                top->children[0] = root;
+                root = top;
+                try{
+                    top->children[1] = new_path(Shift, tail);
+                }catch(...){
+                    root = static_cast<Branch*>(top->children[0]);
+                    delete top;
+                    throw;
+                }
+                Shift += BITS;
+            }else{
+                root = editable(root, Shift);
+                push_leaf(root, Shift, tail);
+            }
+            tail = nullptr;
+        }
+
+    public:
+
+        Trie() noexcept :
+        Size{0}, Shift{BITS}, root{nullptr}, tail{nullptr} {}
+
+
+        // Shares every node of other
+        Trie(const Trie& other) noexcept :
+        Size{other.Size}, Shift{other.Shift}, root{other.root}, tail{other.tail} {
+            retain(root);
+            retain(tail);
+        }
+
+
+        Trie(Trie&& other) noexcept :
+        Size{std::exchange(other.Size, 0)}, Shift{std::exchange(other.Shift, BITS)},
+        root{std::exchange(other.root, nullptr)}, tail{std::exchange(other.tail, nullptr)} {}
+
+
+        Trie& operator=(Trie other) noexcept {
+            std::swap(Size, other.Size);
+            std::swap(Shift, other.Shift);
+            std::swap(root, other.root);
+            std::swap(tail, other.tail);
+            return *this;
+        }
+
+
+        // Returns the index of the first element in the tail
+        [[nodiscard]] size_type tail_offset() const noexcept {
+            return Size < WIDTH ? 0 : ((Size - 1) >> BITS) << BITS;
+        }
+
+
+        [[nodiscard]] size_type size() const noexcept {
+            return Size;
+        }
+
+
+        // Returns element i, walking one branch per level
+        [[nodiscard]] const T& get(const size_type i) const noexcept {
+            if(i >= tail_offset()) return tail->elts()[i & MASK];
+            const Node* node = root;
+            for(size_type level = Shift; level > 0; level -= BITS){
+                node = static_cast<const Branch*>(node)->children[(i >> level) & MASK];
+            }
+            return static_cast<const Leaf<T>*>(node)->elts()[i & MASK];
+        }
+
+
+        // Appends an element, copying only the nodes that are shared
+        template<class... Args>
+        void emplace_back(Args&&... args){
+            if(tail != nullptr && tail->count < WIDTH){
+                tail = editable(tail);
+                std::construct_at(tail->elts() + tail->count, std::forward<Args>(args)...);
+                ++tail->count;
+                ++Size;
+                return;
+            }
+
+            // Build the new tail first, so a throwing constructor leaves the trie unchanged
+            Leaf<T>* fresh = new Leaf<T>;
+            try{
+                std::construct_at(fresh->elts(), std::forward<Args>(args)...);
+                fresh->count = 1;
+                if(tail != nullptr) push_tail();
+            }catch(...){
+                delete fresh;
+                throw;
+            }
+            tail = fresh;
+            ++Size;
+        }
+
+
+        // Replaces element i, copying only the nodes on its path that are shared
+        template<class U>
+        void set(const size_type i, U&& value){
+            if(i >= tail_offset()){
+                tail = editable(tail);
+                tail->elts()[i & MASK] = std::forward<U>(value);
+                return;
+            }
+
+            root = editable(root, Shift);
+            Branch* branch = root;
+            for(size_type level = Shift; level > BITS; level -= BITS){
+                Node*& child = branch->children[(i >> level) & MASK];
+                child = editable(static_cast<Branch*>(child), level - BITS);
+                branch = static_cast<Branch*>(child);
+            }
+            Node*& leaf = branch->children[(i >> BITS) & MASK];
+            leaf = editable(static_cast<Leaf<T>*>(leaf));
+            static_cast<Leaf<T>*>(leaf)->elts()[i & MASK] = std::forward<U>(value);
+        }
+
+
+        ~Trie(){
+            release(root, Shift);
+            release(tail, 0);
+        }
+    };
+}
+
+
+template<class T>
+class TransientVector;
+
+
+// An immutable vector, every change returns a new version that shares the unchanged nodes with the old one
+// Elements live in a 32-way trie, so push_back, set and indexing walk log32(n) levels, at most 7 for 2^32 elements
+// Versions can be read and copied from many threads, the nodes are reference counted atomically
+template<class T>
+class PersistentVector{
+public:
+    typedef std::size_t size_type;
+
+    // Elements per node
+    static constexpr size_type WIDTH = persistent_detail::WIDTH;
+
+private:
+    friend class TransientVector<T>;
+
+    persistent_detail::Trie<T> trie;    // The nodes of this version
+
+
+    explicit PersistentVector(persistent_detail::Trie<T>&& _trie) noexcept :
+    trie{std::move(_trie)} {}
+
+protected:
+
+    template<class Access_Type>
+    using IteratorType = Index_Iterator<const PersistentVector, Access_Type>;
+
+public:
+
+    // STL compliant const iterator, elements of a version never change
+    typedef IteratorType<const T> const_iterator;
+    typedef const_iterator iterator;
+
+
+    // Default constructor
+    PersistentVector() noexcept = default;
+
+
+    // Initializer list constructor
+    PersistentVector(std::initializer_list<T> list);
+
+
+    // Returns a new version with elt added to the back
+    // Copies the tail, and when the tail is full the path to its new place in the trie
+    [[nodiscard]] PersistentVector push_back(const T& elt) const {
+        persistent_detail::Trie<T> next(trie);
+        next.emplace_back(elt);
+        return PersistentVector(std::move(next));
+    }
+
+
+    // Returns a new version with elt moved to the back
+    [[nodiscard]] PersistentVector push_back(T&& elt) const {
+        persistent_detail::Trie<T> next(trie);
+        next.emplace_back(std::move(elt));
+        return PersistentVector(std::move(next));
+    }
+
+
+    // Returns a new version with element i replaced by elt
+    // Copies the log32(n) nodes on the path to i, every other node is shared
+    // Throws std::out_of_range when i >= size()
+    [[nodiscard]] PersistentVector set(const size_type i, const T& elt) const {
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        persistent_detail::Trie<T> next(trie);
+        next.set(i, elt);
+        return PersistentVector(std::move(next));
+    }
+
+
+    // Returns a TransientVector starting from this version, for changing many elements in place
+    [[nodiscard]] TransientVector<T> transient() const {
+        return TransientVector<T>(*this);
+    }
+
+
+    // Returns the size of the vector
+    [[nodiscard]] size_type size() const noexcept {
+        return trie.size();
+    }
+
+
+    // Returns true if the vector is empty
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+
+    // Returns a const reference to the indexed element
+    [[nodiscard]] const T& at(const size_type i) const {
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return trie.get(i);
+    }
+
+
+    // Returns a const reference to the first element in the vector
+    [[nodiscard]] const T& front() const {
+        return at(0);
+    }
+
+
+    // Returns a const reference to the final element in the vector
+    [[nodiscard]] const T& back() const {
+        if(size() == 0) throw std::out_of_range("Indexed out of range");
+        return at(size() - 1);
+    }
+
+
+    // Operator overload to allow direct const indexing
+    [[nodiscard]] const T& operator[](const size_type i) const noexcept {
+        return trie.get(i);
+    }
+
+
+    // Returns a const iterator to the first element in the vector
+    [[nodiscard]] const_iterator cbegin() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty PersistentVector");
+        return const_iterator(this, 0);
+    }
+
+
+    // Returns a const iterator one element past the last element in the vector
+    [[nodiscard]] const_iterator cend() const {
+        return cbegin() + size();
+    }
+
+
+    // Returns a const iterator to the first element in the vector
+    [[nodiscard]] const_iterator begin() const {
+        return cbegin();
+    }
+
+
+    // Returns a const iterator one element past the last element in the vector
+    [[nodiscard]] const_iterator end() const {
+        return cend();
+    }
+};
+
+
+// A mutable builder over the trie of a PersistentVector
+// Nodes it created or already copied have no other owner, so it changes them in place instead of copying a path per change
+// Not safe to use from several threads at once
+template<class T>
+class TransientVector{
+public:
+    typedef std::size_t size_type;
+
+private:
+    friend class PersistentVector<T>;
+
+    persistent_detail::Trie<T> trie;    // The nodes, shared with the source version until first written
+
+
+    explicit TransientVector(const PersistentVector<T>& source) noexcept :
+    trie{source.trie} {}
+
+public:
+
+    // Default constructor
+    TransientVector() noexcept = default;
+
+
+    // Adds the given element in place in memory
+    template<class... Args>
+    void emplace_back(Args&&... args){
+        trie.emplace_back(std::forward<Args>(args)...);
+    }
+
+
+    // Adds the given const element to the back of the vector
+    void push_back(const T& elt){
+        trie.emplace_back(elt);
+    }
+
+
+    // Adds the given element to the back of the vector in place
+    void push_back(T&& elt){
+        trie.emplace_back(std::move(elt));
+    }
+
+
+    // Replaces element i with elt
+    // Throws std::out_of_range when i >= size()
+    void set(const size_type i, const T& elt){
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        trie.set(i, elt);
+    }
+
+
+    // Returns the size of the vector
+    [[nodiscard]] size_type size() const noexcept {
+        return trie.size();
+    }
+
+
+    // Returns true if the vector is empty
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+
+    // Returns a const reference to the indexed element
+    [[nodiscard]] const T& at(const size_type i) const {
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return trie.get(i);
+    }
+
+
+    // Operator overload to allow direct const indexing
+    [[nodiscard]] const T& operator[](const size_type i) const noexcept {
+        return trie.get(i);
+    }
+
+
+    // Returns the elements as a PersistentVector without copying, and leaves this transient empty
+    [[nodiscard]] PersistentVector<T> persistent() noexcept {
+        return PersistentVector<T>(std::move(trie));
+    }
+};
+
+
+// Built through a transient, so the list is added in place
+template<class T>
+PersistentVector<T>::PersistentVector(std::initializer_list<T> list){
+    TransientVector<T> builder;
+    for(const T& elt : list){
+        builder.push_back(elt);
+    }
+    trie = std::move(builder.trie);
+}
+
+#endif
@@ -0,0 +1,398 @@
+#ifndef SMALL_VECTOR_HPP
+#define SMALL_VECTOR_HPP
+
+#include "Vector.hpp"
+
+
+// A Vector that keeps up to N elements inside the object itself
+// Only spills to Allocator once more than N elements are stored
+template<class T, std::size_t N, class Allocator = std::allocator<T>, class GrowthPolicy = Double_Growth>
+class SmallVector{
+    static_assert(N > 0, "SmallVector needs room for at least one inline element");
+public:
+    typedef std::size_t size_type;
+    typedef Allocator allocator_type;
+    typedef GrowthPolicy growth_policy;
+private:
+    typedef std::allocator_traits<Allocator> alloc_traits;
+
+    // Elements may be moved with memcpy instead of constructor calls
+    static constexpr bool memcpy_relocate = is_trivially_relocatable_v<T> && !has_custom_construct<Allocator, T>::value;
+
+    size_type Size;                                 // The Current number of elements in the vector
+    size_type Capacity;                             // N while inline, otherwise the size of the heap array
+    T* arr;                                         // Points to buffer while inline, otherwise to the heap array
+    Allocator alloc;                                // The allocator used once the vector spills to the heap
+    alignas(T) unsigned char buffer[N * sizeof(T)]; // Raw inline storage for the first N elements
+
+
+    // Returns a pointer to the inline storage
+    [[nodiscard]] T* inline_data() noexcept {
+        return reinterpret_cast<T*>(buffer);
+    }
+
+
+    // Destroys the elements in [first, last) without releasing memory
+    void destroy_range(const size_type first, const size_type last) noexcept {
+        for(size_type i = first; i < last; ++i){
+            alloc_traits::destroy(alloc, arr + i);
+        }
+    }
+
+
+    // Destroys every element, frees any heap array, and returns to the inline storage
+    void release() noexcept {
+        destroy_range(0, size());
+        if(!is_inline()) alloc_traits::deallocate(alloc, arr, capacity());
+        arr = inline_data();
+        Size = 0;
+        Capacity = N;
+    }
+
+
+    // Moves the first count elements into a new array of new_capacity slots
+    // Uses the inline storage when new_capacity fits in it
+    void reallocate(const size_type new_capacity, const size_type count){
+        const bool to_inline = new_capacity <= N;
+        T* temp = to_inline ? inline_data() : alloc_traits::allocate(alloc, new_capacity);
+
+        if constexpr(memcpy_relocate){
+            destroy_range(count, size());
+            if(count > 0) std::memcpy(static_cast<void*>(temp), static_cast<const void*>(arr), count * sizeof(T));
+        }else{
+            size_type i = 0;
+            try{
+                for(; i < count; ++i){
+                    alloc_traits::construct(alloc, temp + i, std::move_if_noexcept(arr[i]));
+                }
+            }catch(...){
+                for(size_type j = 0; j < i; ++j) alloc_traits::destroy(alloc, temp + j);
+                if(!to_inline) alloc_traits::deallocate(alloc, temp, new_capacity);
+                throw;
+            }
+            destroy_range(0, size());
+        }
+
+        if(!is_inline()) alloc_traits::deallocate(alloc, arr, capacity());
+        arr = temp;
+        Size = count;
+        Capacity = to_inline ? N : new_capacity;
+    }
+
+
+    // Grows the heap array by GrowthPolicy when size reaches capacity
+    void grow(){
+        reallocate(GrowthPolicy::template next<T>(capacity(), size() + 1), size());
+    }
+
+
+    // Takes the elements of other, stealing its heap array if it has one
+    // REQUIRES this to be empty and inline
+    void take(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if(other.is_inline()){
+            for(; Size < other.size(); ++Size){
+                alloc_traits::construct(alloc, arr + Size, std::move(other[Size]));
+            }
+            other.release();
+            return;
+        }
+
+        arr = other.arr;
+        Size = other.Size;
+        Capacity = other.Capacity;
+        other.arr = other.inline_data();
+        other.Size = 0;
+        other.Capacity = N;
+    }
+
+protected:
+
+    template<class Access_Type>
+    using IteratorType = Vector_Iterator<Access_Type>;
+
+public:
+
+    // STL compliant iterator allowing mutable elements
+    typedef IteratorType<T> iterator;
+
+    // STL compliant const iterator ensuring elements cannot be changed
+    typedef IteratorType<const T> const_iterator;
+
+
+    // Default constructor
+    SmallVector() noexcept(noexcept(Allocator())) :
+    Size{0}, Capacity{N}, arr{inline_data()}, alloc{} {}
+
+
+    // Allocator constructor
+    explicit SmallVector(const Allocator& _alloc) noexcept :
+    Size{0}, Capacity{N}, arr{inline_data()}, alloc{_alloc} {}
+
+
+    // Size constructor with default value
+    explicit SmallVector(const size_type _size, const Allocator& _alloc = Allocator()) :
+    SmallVector(_alloc) {
+        resize(_size);
+    }
+
+
+    // Size constructor with given value
+    SmallVector(const size_type _size, const T& elt, const Allocator& _alloc = Allocator()) :
+    SmallVector(_alloc) {
+        reserve(_size);
+        for(size_type _ = 0; _ < _size; ++_){
+            push_back(elt);
+        }
+    }
+
+
+    // Copy constructor
+    // Only spills to the heap if other holds more than N elements
+    SmallVector(const SmallVector& other) :
+    SmallVector(alloc_traits::select_on_container_copy_construction(other.alloc)) {
+        reserve(other.size());
+        for(; Size < other.size(); ++Size){
+            alloc_traits::construct(alloc, arr + Size, other[Size]);
+        }
+    }
+
+
+    // Move constructor
+    // O(1) when other is on the heap, O(n) moves when it is inline
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) :
+    SmallVector(other.alloc) {
+        take(other);
+    }
+
+
+    // Copy assignment
+    SmallVector& operator=(const SmallVector& other){
+        // Guard self assignment
+        if(this == &other) return *this;
+
+        SmallVector temp(other);
+        *this = std::move(temp);
+
+        return *this;
+    }
+
+
+    // Move assignment
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        // Guard self assignment
+        if(this == &other) return *this;
+
+        release();
+        alloc = other.alloc;
+        take(other);
+        return *this;
+    }
+
+
+    // Adds the given element in place in memory
+    template<class... Args>
+    void emplace_back(Args&&... args){
+        if(size() == capacity()) grow();
+        alloc_traits::construct(alloc, arr + size(), std::forward<Args>(args)...);
+        ++Size;
+    }
+
+
+    // Adds the given const element to the back of the vector
+    void push_back(const T& elt){
+        emplace_back(elt);
+    }
+
+
+    // Adds the given element to the back of the vector in place
+    void push_back(T&& elt){
+        emplace_back(std::move(elt));
+    }
+
+
+    // Returns the size of the vector
+    [[nodiscard]] constexpr size_type size() const noexcept {
+        return Size;
+    }
+
+
+    // Returns the capacity of the vector
+    [[nodiscard]] constexpr size_type capacity() const noexcept {
+        return Capacity;
+    }
+
+
+    // Returns the number of elements that fit without touching the heap
+    [[nodiscard]] static constexpr size_type inline_capacity() noexcept {
+        return N;
+    }
+
+
+    // Returns true while the elements live in the inline storage
+    [[nodiscard]] bool is_inline() const noexcept {
+        return arr == reinterpret_cast<const T*>(buffer);
+    }
+
+
+    // Returns true if the vector is empty
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        return Size == 0;
+    }
+
+
+    // Returns a reference to the indexed element
+    [[nodiscard]] T& at(const size_type i){
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return arr[i];
+    }
+
+
+    // Returns a const reference to the indexed element
+    [[nodiscard]] const T& at(const size_type i) const {
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return arr[i];
+    }
+
+
+    // Returns a reference to the first element in the vector
+    [[nodiscard]] T& front(){
+        return at(0);
+    }
+
+
+    // Returns a const reference to the first element in the vector
+    [[nodiscard]] const T& front() const {
+        return at(0);
+    }
+
+
+    // Returns a reference to the final element in the vector
+    [[nodiscard]] T& back(){
+        if(size() == 0) throw std::out_of_range("Indexed out of range");
+        return at(size() - 1);
+    }
+
+
+    // Returns a const reference to the final element in the vector
+    [[nodiscard]] const T& back() const {
+        if(size() == 0) throw std::out_of_range("Indexed out of range");
+        return at(size() - 1);
+    }
+
+
+    // Operator overload to allow direct indexing
+    [[nodiscard]] T& operator[](const size_type i) noexcept {
+        return arr[i];
+    }
+
+
+    // Operator overload to allow direct const indexing
+    [[nodiscard]] const T& operator[](const size_type i) const noexcept {
+        return arr[i];
+    }
+
+
+    // Returns an iterator to the first element in the vector
+    [[nodiscard]] iterator begin() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty SmallVector");
+        return iterator(arr);
+    }
+
+
+    // Returns an iterator one element past the last element in the vector
+    [[nodiscard]] iterator end() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty SmallVector");
+        return iterator(arr + size());
+    }
+
+
+    // Returns a const iterator to the first element in the vector
+    [[nodiscard]] const_iterator cbegin() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty SmallVector");
+        return const_iterator(arr);
+    }
+
+
+    // Returns a const iterator one element past the last element in the vector
+    [[nodiscard]] const_iterator cend() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty SmallVector");
+        return const_iterator(arr + size());
+    }
+
+
+    // Removes the last element in the vector
+    void pop_back(){
+        if(empty()) throw std::out_of_range("Cannot remove element from empty vector");
+        --Size;
+        alloc_traits::destroy(alloc, arr + size());
+    }
+
+
+    // Clear the vector
+    // Keeps any heap array allocated
+    void clear() noexcept {
+        destroy_range(0, size());
+        Size = 0;
+    }
+
+
+    // Shrinks the heap array to the number of elements
+    // Moves the elements back into the inline storage when they fit
+    void shrink_to_fit(){
+        if(is_inline() || capacity() == size()) return;
+
+        reallocate(size(), size());
+    }
+
+
+    // Allocates at least _size elements in of space
+    // Only affects capacity
+    void reserve(const size_type _size){
+        if(_size <= capacity()) return;
+
+        reallocate(_size, size());
+    }
+
+
+    // Resizes the vector to _size elements
+    // Fills empty space with default values and reuses the current capacity when possible
+    void resize(const size_type _size){
+        if(_size < size()){
+            destroy_range(_size, size());
+            Size = _size;
+            return;
+        }
+
+        reserve(_size);
+        for(; Size < _size; ++Size){
+            alloc_traits::construct(alloc, arr + Size);
+        }
+    }
+
+
+    // Returns a pointer to the underlying array
+    // Assumes class invariants will not be invalidated.
+    [[nodiscard]] T* data() noexcept {
+        return arr;
+    }
+
+
+    // Returns a const pointer to the underlying array
+    [[nodiscard]] const T* data() const noexcept {
+        return arr;
+    }
+
+
+    // Returns a copy of the allocator
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return alloc;
+    }
+
+
+    // Destructor
+    ~SmallVector(){
+        release();
+    }
+};
+
+#endif
@@ -0,0 +1,400 @@
+#ifndef SOA_VECTOR_HPP
+#define SOA_VECTOR_HPP
+
+#include "Vector.hpp"
+#include <tuple>
+
+
+// Random access iterator over the rows of a SoaVector
+// Dereferencing yields a proxy, a tuple of references into every column
+template<class... Access_Types>
+class Soa_Iterator{
+public:
+    // Iterator traits to make the iterator stl compliant
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::tuple<std::remove_const_t<Access_Types>...>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::tuple<Access_Types&...>;
+
+
+protected:
+    std::tuple<Access_Types*...> columns;   // The first element of every column
+    std::size_t idx;                        // The row this iterator points to
+
+public:
+    // Iterator to row _idx of the given columns
+    constexpr Soa_Iterator(const std::tuple<Access_Types*...>& _columns, const std::size_t _idx) noexcept :
+    columns{_columns}, idx{_idx} {}
+
+
+    // Dereference operator overload
+    [[nodiscard]] constexpr reference operator*() const noexcept {
+        return (*this)[0];
+    }
+
+
+    // Access operator
+    [[nodiscard]] constexpr reference operator[](const std::size_t i) const noexcept {
+        return std::apply([this, i](Access_Types*... cols){ return reference(cols[idx + i]...); }, columns);
+    }
+
+
+    // Prefix increment
+    constexpr Soa_Iterator& operator++() noexcept {
+        ++idx;
+        return *this;
+    }
+
+
+    // Postfix increment
+    constexpr Soa_Iterator operator++(int) noexcept {
+        Soa_Iterator temp(*this);
+        ++idx;
+        return temp;
+    }
+
+
+    // Prefix decrement
+    constexpr Soa_Iterator& operator--() noexcept {
+        --idx;
+        return *this;
+    }
+
+
+    // Postfix decrement
+    constexpr Soa_Iterator operator--(int) noexcept {
+        Soa_Iterator temp(*this);
+        --idx;
+        return temp;
+    }
+
+
+    // Compound Assignments
+    constexpr Soa_Iterator& operator+=(const std::size_t offset) noexcept {
+        idx += offset;
+        return *this;
+    }
+    constexpr Soa_Iterator& operator-=(const std::size_t offset) noexcept {
+        idx -= offset;
+        return *this;
+    }
+
+
+    // Addition
+    [[nodiscard]] friend constexpr Soa_Iterator operator+(Soa_Iterator it, const std::size_t offset) noexcept {
+        return it += offset;
+    }
+    [[nodiscard]] friend constexpr Soa_Iterator operator+(const std::size_t offset, Soa_Iterator it) noexcept {
+        return it += offset;
+    }
+
+
+    // Subtraction
+    [[nodiscard]] friend constexpr Soa_Iterator operator-(Soa_Iterator it, const std::size_t offset) noexcept {
+        return it -= offset;
+    }
+
+
+    [[nodiscard]] constexpr difference_type operator-(const Soa_Iterator& other) const noexcept {
+        return static_cast<difference_type>(idx) - static_cast<difference_type>(other.idx);
+    }
+
+
+    // Equality operator overload
+    // Iterators of the same SoaVector are equal when they point to the same row
+    [[nodiscard]] friend constexpr bool operator==(const Soa_Iterator& left, const Soa_Iterator& right) noexcept {
+        return left.idx == right.idx && std::get<0>(left.columns) == std::get<0>(right.columns);
+    }
+
+
+    // Inequality operator overload
+    [[nodiscard]] friend constexpr bool operator!=(const Soa_Iterator& left, const Soa_Iterator& right) noexcept {
+        return !(left == right);
+    }
+
+
+    // Comparison operators
+    [[nodiscard]] constexpr bool operator<(const Soa_Iterator& other) const noexcept {
+        return idx < other.idx;
+    }
+    [[nodiscard]] constexpr bool operator<=(const Soa_Iterator& other) const noexcept {
+        return idx <= other.idx;
+    }
+    [[nodiscard]] constexpr bool operator>(const Soa_Iterator& other) const noexcept {
+        return idx > other.idx;
+    }
+    [[nodiscard]] constexpr bool operator>=(const Soa_Iterator& other) const noexcept {
+        return idx >= other.idx;
+    }
+};
+
+
+// A structure of arrays: one contiguous Vector per field, all of the same length
+// Scanning one field only touches that field's column, and columns can be handed to vectorized loops as spans
+template<class... Ts>
+class SoaVector{
+    static_assert(sizeof...(Ts) > 0, "SoaVector needs at least one column");
+public:
+    typedef std::size_t size_type;
+
+    // The element type of column I
+    template<size_type I>
+    using column_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    // Proxy references to a whole row
+    typedef std::tuple<Ts&...> reference;
+    typedef std::tuple<const Ts&...> const_reference;
+
+private:
+
+    std::tuple<Vector<Ts>...> columns;  // One array per field, all with the same size and capacity
+
+
+    // Calls f on every column
+    template<class F>
+    void for_each_column(F&& f){
+        std::apply([&f](Vector<Ts>&... cols){ (f(cols), ...); }, columns);
+    }
+
+
+    // Grows every column to the same new capacity at once
+    void grow(){
+        reserve(Double_Growth::template next<column_type<0>>(capacity(), size() + 1));
+    }
+
+
+    // Adds one value to every column, removing the values already added if one throws
+    template<size_type... I, class... Args>
+    void emplace_columns(std::index_sequence<I...>, Args&&... args){
+        size_type done = 0;
+        try{
+            ((std::get<I>(columns).emplace_back(std::forward<Args>(args)), ++done), ...);
+        }catch(...){
+            ((I < done ? std::get<I>(columns).pop_back() : void()), ...);
+            throw;
+        }
+    }
+
+
+    // Resizes every column to _size rows
+    // If one throws, it and the columns before it are shrunk back to old_size, dropping any rows it had built
+    template<size_type... I>
+    void resize_columns(std::index_sequence<I...>, const size_type old_size, const size_type _size){
+        size_type done = 0;
+        try{
+            ((std::get<I>(columns).resize(_size), ++done), ...);
+        }catch(...){
+            ((I <= done ? std::get<I>(columns).resize(old_size) : void()), ...);
+            throw;
+        }
+    }
+
+
+    // Returns the proxy to row i
+    template<class Ref, class Self>
+    [[nodiscard]] static Ref row(Self& self, const size_type i) noexcept {
+        return std::apply([i](auto&... cols){ return Ref(cols[i]...); }, self.columns);
+    }
+
+protected:
+
+    template<class... Access_Types>
+    using IteratorType = Soa_Iterator<Access_Types...>;
+
+public:
+
+    // STL compliant iterator over rows allowing mutable elements
+    typedef IteratorType<Ts...> iterator;
+
+    // STL compliant iterator over rows ensuring elements cannot be changed
+    typedef IteratorType<const Ts...> const_iterator;
+
+
+    // Default constructor
+    SoaVector() = default;
+
+
+    // Size constructor with default values
+    explicit SoaVector(const size_type _size){
+        resize(_size);
+    }
+
+
+    // Adds a row, constructing each column's element from the matching argument
+    template<class... Args>
+    void emplace_back(Args&&... args){
+        static_assert(sizeof...(Args) == sizeof...(Ts), "emplace_back takes one argument per column");
+        if(size() == capacity()) grow();
+        emplace_columns(std::index_sequence_for<Ts...>{}, std::forward<Args>(args)...);
+    }
+
+
+    // Copies a row to the back of the vector
+    void push_back(const Ts&... vals){
+        emplace_back(vals...);
+    }
+
+
+    // Moves a row to the back of the vector
+    void push_back(Ts&&... vals){
+        emplace_back(std::move(vals)...);
+    }
+
+
+    // Returns the number of rows
+    [[nodiscard]] size_type size() const noexcept {
+        return std::get<0>(columns).size();
+    }
+
+
+    // Returns the number of rows every column has space for
+    [[nodiscard]] size_type capacity() const noexcept {
+        return std::get<0>(columns).capacity();
+    }
+
+
+    // Returns true if there are no rows
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+
+    // Returns the contiguous elements of column I
+    template<size_type I>
+    [[nodiscard]] std::span<column_type<I>> column() noexcept {
+        return std::span<column_type<I>>(std::get<I>(columns).data(), size());
+    }
+
+
+    // Returns the contiguous const elements of column I
+    template<size_type I>
+    [[nodiscard]] std::span<const column_type<I>> column() const noexcept {
+        return std::span<const column_type<I>>(std::get<I>(columns).data(), size());
+    }
+
+
+    // Returns proxy references to the indexed row
+    [[nodiscard]] reference at(const size_type i){
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return row<reference>(*this, i);
+    }
+
+
+    // Returns const proxy references to the indexed row
+    [[nodiscard]] const_reference at(const size_type i) const {
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return row<const_reference>(*this, i);
+    }
+
+
+    // Returns proxy references to the first row
+    [[nodiscard]] reference front(){
+        return at(0);
+    }
+
+
+    // Returns const proxy references to the first row
+    [[nodiscard]] const_reference front() const {
+        return at(0);
+    }
+
+
+    // Returns proxy references to the last row
+    [[nodiscard]] reference back(){
+        if(empty()) throw std::out_of_range("Indexed out of range");
+        return at(size() - 1);
+    }
+
+
+    // Returns const proxy references to the last row
+    [[nodiscard]] const_reference back() const {
+        if(empty()) throw std::out_of_range("Indexed out of range");
+        return at(size() - 1);
+    }
+
+
+    // Operator overload to allow direct indexing of rows
+    [[nodiscard]] reference operator[](const size_type i) noexcept {
+        return row<reference>(*this, i);
+    }
+
+
+    // Operator overload to allow direct const indexing of rows
+    [[nodiscard]] const_reference operator[](const size_type i) const noexcept {
+        return row<const_reference>(*this, i);
+    }
+
+
+    // Returns an iterator to the first row
+    [[nodiscard]] iterator begin(){
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty SoaVector");
+        return iterator(std::apply([](Vector<Ts>&... cols){ return std::make_tuple(cols.data()...); }, columns), 0);
+    }
+
+
+    // Returns an iterator one past the last row
+    [[nodiscard]] iterator end(){
+        return begin() + size();
+    }
+
+
+    // Returns a const iterator to the first row
+    [[nodiscard]] const_iterator cbegin() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty SoaVector");
+        return const_iterator(std::apply([](const Vector<Ts>&... cols){ return std::make_tuple(cols.data()...); }, columns), 0);
+    }
+
+
+    // Returns a const iterator one past the last row
+    [[nodiscard]] const_iterator cend() const {
+        return cbegin() + size();
+    }
+
+
+    // Returns a const iterator to the first row
+    [[nodiscard]] const_iterator begin() const {
+        return cbegin();
+    }
+
+
+    // Returns a const iterator one past the last row
+    [[nodiscard]] const_iterator end() const {
+        return cend();
+    }
+
+
+    // Removes the last row
+    void pop_back(){
+        if(empty()) throw std::out_of_range("Cannot remove element from empty vector");
+        for_each_column([](auto& col){ col.pop_back(); });
+    }
+
+
+    // Removes every row while keeping the columns allocated
+    void clear() noexcept {
+        for_each_column([](auto& col){ col.clear(); });
+    }
+
+
+    // Shrinks every column to the number of rows
+    void shrink_to_fit(){
+        for_each_column([](auto& col){ col.shrink_to_fit(); });
+    }
+
+
+    // Allocates space for at least _size rows in every column
+    void reserve(const size_type _size){
+        for_each_column([_size](auto& col){ col.reserve(_size); });
+    }
+
+
+    // Resizes every column to _size rows, filling new rows with default values
+    // If a column throws, every column keeps the old number of rows
+    void resize(const size_type _size){
+        if(_size > size()) reserve(_size);
+        resize_columns(std::index_sequence_for<Ts...>{}, size(), _size);
+    }
+};
+
+#endif
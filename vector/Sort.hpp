@@ -0,0 +1,190 @@
+#ifndef SORT_HPP
+#define SORT_HPP
+
+#include "Vector.hpp"
+#include "Parallel.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+
+
+namespace sort_detail{
+
+    // The unsigned integer radix_sort() orders keys of type Key by
+    template<class Key>
+    using radix_type = std::conditional_t<sizeof(Key) <= 1, std::uint8_t,
+                       std::conditional_t<sizeof(Key) <= 2, std::uint16_t,
+                       std::conditional_t<sizeof(Key) <= 4, std::uint32_t, std::uint64_t>>>;
+
+
+    // Maps key to an unsigned integer with the same order
+    // Signed integers flip the sign bit, floats flip the sign bit of positives and every bit of negatives
+    template<class Key>
+    [[nodiscard]] constexpr radix_type<Key> radix_bits(const Key key) noexcept {
+        static_assert(std::is_arithmetic_v<Key> && !std::is_same_v<Key, bool>, "Radix keys must be integers or floating point");
+        typedef radix_type<Key> U;
+        constexpr U SIGN = U(1) << (sizeof(U) * 8 - 1);
+
+        if constexpr(std::is_floating_point_v<Key>){
+            static_assert(sizeof(Key) == sizeof(U), "Only float and double keys are supported");
+            const U bits = std::bit_cast<U>(key);
+            return (bits & SIGN) ? U(~bits) : U(bits | SIGN);
+        }else if constexpr(std::is_signed_v<Key>){
+            return U(static_cast<U>(key) ^ SIGN);
+        }else{
+            return static_cast<U>(key);
+        }
+    }
+
+
+    // Returns the number of the stable merge of a[0, m) and b[0, n) taken from a within its first k elements
+    template<class T, class Compare>
+    [[nodiscard]] std::size_t co_rank(const std::size_t k, const T* a, const std::size_t m, const T* b, const std::size_t n, Compare& comp){
+        std::size_t lo = k > n ? k - n : 0;
+        std::size_t hi = std::min(k, m);
+        while(lo < hi){
+            const std::size_t mid = lo + (hi - lo + 1) / 2;
+            // a[mid - 1] is among the first k when it does not come after b[k - mid]
+            if(!comp(b[k - mid], a[mid - 1])) lo = mid;
+            else hi = mid - 1;
+        }
+        return lo;
+    }
+}
+
+
+// Sorts range in place with a stable least significant digit radix sort on key(element)
+// key returns an integer, float or double, negative floats sort before positive ones and -0.0 before 0.0
+// Takes one byte of the key per pass and skips passes in which every key has the same byte
+// Elements are moved through one scratch Vector of the same size, so they must be default constructible
+template<Contiguous_Range Range, class Key>
+void radix_sort(Range&& range, Key key){
+    auto* elts = range.data();
+    typedef std::remove_pointer_t<decltype(elts)> T;
+    typedef decltype(sort_detail::radix_bits(key(*elts))) U;
+    constexpr std::size_t PASSES = sizeof(U);
+
+    const std::size_t n = range.size();
+    if(n < 2) return;
+
+    // Every histogram is built in a single read of the keys
+    Vector<std::size_t> counts(PASSES * 256);
+    for(std::size_t i = 0; i < n; ++i){
+        const U bits = sort_detail::radix_bits(key(elts[i]));
+        for(std::size_t pass = 0; pass < PASSES; ++pass){
+            ++counts[pass * 256 + ((bits >> (pass * 8)) & 0xFF)];
+        }
+    }
+
+    Vector<T> scratch;
+    T* from = elts;
+    T* to = nullptr;
+    for(std::size_t pass = 0; pass < PASSES; ++pass){
+        std::size_t* count = counts.data() + pass * 256;
+        const std::size_t digit = (sort_detail::radix_bits(key(from[0])) >> (pass * 8)) & 0xFF;
+        if(count[digit] == n) continue;
+
+        if(to == nullptr){
+            scratch.resize_for_overwrite(n);
+            to = scratch.data();
+        }
+
+        // Turn the counts into the first output slot of every digit
+        std::size_t offset = 0;
+        for(std::size_t d = 0; d < 256; ++d){
+            offset += std::exchange(count[d], offset);
+        }
+        for(std::size_t i = 0; i < n; ++i){
+            const std::size_t d = (sort_detail::radix_bits(key(from[i])) >> (pass * 8)) & 0xFF;
+            to[count[d]++] = std::move(from[i]);
+        }
+        std::swap(from, to);
+    }
+
+    if(from != elts) std::move(from, from + n, elts);
+}
+
+
+// Sorts range of integers, floats or doubles in place with a radix sort
+template<Contiguous_Range Range>
+void radix_sort(Range&& range){
+    radix_sort(std::forward<Range>(range), [](const auto elt){ return elt; });
+}
+
+
+// Sorts range in place by comp on a Thread_Pool, not stable
+// Splits range into a power of two runs, at least one per participant and no shorter than the grain
+// Each run is sorted with std::sort, then pairs of runs are merged level by level, alternating between
+// range and one scratch Vector of the same size. Every merge is cut into pieces of equal output size with
+// a binary search, so the last levels use every participant too
+template<Contiguous_Range Range, class Compare = std::less<>>
+void parallel_sort(Range&& range, Compare comp = Compare(), const Parallel_Options& options = {}){
+    auto* elts = range.data();
+    typedef std::remove_pointer_t<decltype(elts)> T;
+    const std::size_t n = range.size();
+    Thread_Pool& pool = parallel_detail::pool(options);
+
+    const std::size_t grain = parallel_detail::grain<T>(options);
+    std::size_t runs = 1;
+    while(runs < pool.size() && n / (runs * 2) >= grain) runs *= 2;
+    if(runs == 1){
+        std::sort(elts, elts + n, comp);
+        return;
+    }
+
+    const auto run_start = [n, runs](const std::size_t run){ return n / runs * run + std::min(run, n % runs); };
+    pool.run(runs, [&](const std::size_t run, std::size_t){
+        std::sort(elts + run_start(run), elts + run_start(run + 1), comp);
+    });
+
+    Vector<T> scratch;
+    scratch.resize_for_overwrite(n);
+    T* from = elts;
+    T* to = scratch.data();
+
+    for(std::size_t width = 1; width < runs; width *= 2){
+        const std::size_t merges = runs / (width * 2);
+        const std::size_t pieces = std::max<std::size_t>(1, pool.size() / merges);
+        const auto bounds = [&](const std::size_t merge){
+            return std::array<std::size_t, 3>{run_start(merge * width * 2), run_start(merge * width * 2 + width),
+                                              run_start(merge * width * 2 + width * 2)};
+        };
+        const auto piece_start = [pieces](const std::size_t total, const std::size_t piece){
+            return total / pieces * piece + std::min(piece, total % pieces);
+        };
+
+        // Where each piece starts in the first run of its merge, found before any element is moved
+        Vector<std::size_t> splits(merges * (pieces + 1));
+        pool.run(splits.size(), [&](const std::size_t task, std::size_t){
+            const auto [first, middle, last] = bounds(task / (pieces + 1));
+            splits[task] = sort_detail::co_rank(piece_start(last - first, task % (pieces + 1)), from + first, middle - first,
+                                                from + middle, last - middle, comp);
+        });
+
+        pool.run(merges * pieces, [&](const std::size_t task, std::size_t){
+            const std::size_t merge = task / pieces;
+            const std::size_t piece = task % pieces;
+            const auto [first, middle, last] = bounds(merge);
+
+            // The output [k0, k1) of this piece takes a[i0, i1) and b[k0 - i0, k1 - i1)
+            const std::size_t k0 = piece_start(last - first, piece);
+            const std::size_t k1 = piece_start(last - first, piece + 1);
+            const std::size_t i0 = splits[merge * (pieces + 1) + piece];
+            const std::size_t i1 = splits[merge * (pieces + 1) + piece + 1];
+
+            std::merge(std::make_move_iterator(from + first + i0), std::make_move_iterator(from + first + i1),
+                       std::make_move_iterator(from + middle + (k0 - i0)), std::make_move_iterator(from + middle + (k1 - i1)),
+                       to + first + k0, comp);
+        });
+        std::swap(from, to);
+    }
+
+    if(from != elts){
+        parallel_detail::for_chunks<T>(n, options, [&](const std::size_t first, const std::size_t last, std::size_t, std::size_t){
+            std::move(from + first, from + last, elts + first);
+        });
+    }
+}
+
+#endif
@@ -0,0 +1,377 @@
+#ifndef STABLE_VECTOR_HPP
+#define STABLE_VECTOR_HPP
+
+#include "Vector.hpp"
+#include "Index_Iterator.hpp"
+#include "Geometric_Segments.hpp"
+
+
+// A Vector whose elements never move once added, so pointers and references to them stay valid
+// Elements live in chunks that double in size, listed in a fixed directory
+// Growing only allocates the next chunk, existing elements are never copied
+template<class T, class Allocator = std::allocator<T>>
+class StableVector{
+public:
+    typedef std::size_t size_type;
+    typedef Allocator allocator_type;
+
+    // Elements in the first chunk, a power of two
+    static constexpr size_type FIRST_CHUNK = 16;
+
+private:
+    typedef std::allocator_traits<Allocator> alloc_traits;
+    typedef Geometric_Segments<FIRST_CHUNK> Layout;
+
+    size_type Size;             // The Current number of elements in the vector
+    size_type Chunks;           // The number of allocated chunks, always the first ones of the directory
+    T* chunks[Layout::COUNT];   // The directory, chunk s holds FIRST_CHUNK << s elements
+    Allocator alloc;            // The allocator used for the chunks and their elements
+
+
+    // Allocates the next chunk
+    void add_chunk(){
+        chunks[Chunks] = alloc_traits::allocate(alloc, Layout::size_of(Chunks));
+        ++Chunks;
+    }
+
+
+    // Deallocates every chunk past the first count
+    void free_chunks(const size_type count) noexcept {
+        for(; Chunks > count; --Chunks){
+            alloc_traits::deallocate(alloc, chunks[Chunks - 1], Layout::size_of(Chunks - 1));
+            chunks[Chunks - 1] = nullptr;
+        }
+    }
+
+
+    // Returns the number of chunks needed for _size elements
+    [[nodiscard]] static constexpr size_type chunks_for(const size_type _size) noexcept {
+        return _size == 0 ? 0 : Layout::segment_of(_size - 1) + 1;
+    }
+
+
+    // Destroys the elements in [first, last) without releasing memory
+    void destroy_range(const size_type first, const size_type last) noexcept {
+        for(size_type i = first; i < last; ++i){
+            alloc_traits::destroy(alloc, &(*this)[i]);
+        }
+    }
+
+
+    // Destroys every element and releases every chunk
+    void release() noexcept {
+        destroy_range(0, size());
+        Size = 0;
+        free_chunks(0);
+    }
+
+protected:
+
+    template<class Access_Type>
+    using IteratorType = Index_Iterator<std::conditional_t<std::is_const_v<Access_Type>, const StableVector, StableVector>, Access_Type>;
+
+public:
+
+    // STL compliant iterator allowing mutable elements
+    typedef IteratorType<T> iterator;
+
+    // STL compliant const iterator ensuring elements cannot be changed
+    typedef IteratorType<const T> const_iterator;
+
+
+    // Default constructor
+    explicit StableVector(const Allocator& _alloc = Allocator()) noexcept :
+    Size{0}, Chunks{0}, chunks{}, alloc{_alloc} {}
+
+
+    // Size constructor with default values
+    explicit StableVector(const size_type _size, const Allocator& _alloc = Allocator()) :
+    StableVector(_alloc) {
+        resize(_size);
+    }
+
+
+    // Size constructor with given value
+    StableVector(const size_type _size, const T& elt, const Allocator& _alloc = Allocator()) :
+    StableVector(_alloc) {
+        reserve(_size);
+        for(size_type _ = 0; _ < _size; ++_){
+            push_back(elt);
+        }
+    }
+
+
+    // Initializer list constructor
+    StableVector(std::initializer_list<T> list, const Allocator& _alloc = Allocator()) :
+    StableVector(_alloc) {
+        reserve(list.size());
+        for(const T& elt : list){
+            push_back(elt);
+        }
+    }
+
+
+    // Copy constructor
+    StableVector(const StableVector& other) :
+    StableVector(alloc_traits::select_on_container_copy_construction(other.alloc)) {
+        reserve(other.size());
+        for(size_type i = 0; i < other.size(); ++i){
+            push_back(other[i]);
+        }
+    }
+
+
+    // Move constructor
+    // Takes over the chunks, so pointers into other now point into this vector
+    StableVector(StableVector&& other) noexcept :
+    Size{other.Size}, Chunks{other.Chunks}, chunks{}, alloc{std::move(other.alloc)} {
+        for(size_type s = 0; s < Chunks; ++s){
+            chunks[s] = std::exchange(other.chunks[s], nullptr);
+        }
+        other.Size = 0;
+        other.Chunks = 0;
+    }
+
+
+    // Copy assignment
+    StableVector& operator=(const StableVector& other){
+        // Guard self assignment
+        if(this == &other) return *this;
+
+        StableVector temp(other);
+        *this = std::move(temp);
+
+        return *this;
+    }
+
+
+    // Move assignment
+    StableVector& operator=(StableVector&& other) noexcept {
+        // Guard self assignment
+        if(this == &other) return *this;
+
+        release();
+        alloc = std::move(other.alloc);
+        Size = std::exchange(other.Size, 0);
+        Chunks = std::exchange(other.Chunks, 0);
+        for(size_type s = 0; s < Chunks; ++s){
+            chunks[s] = std::exchange(other.chunks[s], nullptr);
+        }
+        return *this;
+    }
+
+
+    // Adds the given element in place in memory
+    // Never moves existing elements, at most one new chunk is allocated
+    template<class... Args>
+    T& emplace_back(Args&&... args){
+        if(size() == capacity()) add_chunk();
+        T* slot = &(*this)[size()];
+        alloc_traits::construct(alloc, slot, std::forward<Args>(args)...);
+        ++Size;
+        return *slot;
+    }
+
+
+    // Adds the given const element to the back of the vector
+    void push_back(const T& elt){
+        emplace_back(elt);
+    }
+
+
+    // Adds the given element to the back of the vector in place
+    void push_back(T&& elt){
+        emplace_back(std::move(elt));
+    }
+
+
+    // Returns the size of the vector
+    [[nodiscard]] size_type size() const noexcept {
+        return Size;
+    }
+
+
+    // Returns the number of elements the allocated chunks hold
+    [[nodiscard]] size_type capacity() const noexcept {
+        return Layout::start_of(Chunks);
+    }
+
+
+    // Returns true if the vector is empty
+    [[nodiscard]] bool empty() const noexcept {
+        return Size == 0;
+    }
+
+
+    // Returns a reference to the indexed element
+    [[nodiscard]] T& at(const size_type i){
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return (*this)[i];
+    }
+
+
+    // Returns a const reference to the indexed element
+    [[nodiscard]] const T& at(const size_type i) const {
+        if(i >= size()) throw std::out_of_range("Indexed out of range");
+        return (*this)[i];
+    }
+
+
+    // Returns a reference to the first element in the vector
+    [[nodiscard]] T& front(){
+        return at(0);
+    }
+
+
+    // Returns a const reference to the first element in the vector
+    [[nodiscard]] const T& front() const {
+        return at(0);
+    }
+
+
+    // Returns a reference to the final element in the vector
+    [[nodiscard]] T& back(){
+        if(size() == 0) throw std::out_of_range("Indexed out of range");
+        return at(size() - 1);
+    }
+
+
+    // Returns a const reference to the final element in the vector
+    [[nodiscard]] const T& back() const {
+        if(size() == 0) throw std::out_of_range("Indexed out of range");
+        return at(size() - 1);
+    }
+
+
+    // Operator overload to allow direct indexing
+    // One bit scan finds the chunk, no loop over the directory
+    [[nodiscard]] T& operator[](const size_type i) noexcept {
+        return chunks[Layout::segment_of(i)][Layout::offset_of(i)];
+    }
+
+
+    // Operator overload to allow direct const indexing
+    [[nodiscard]] const T& operator[](const size_type i) const noexcept {
+        return chunks[Layout::segment_of(i)][Layout::offset_of(i)];
+    }
+
+
+    // Returns an iterator to the first element in the vector
+    [[nodiscard]] iterator begin(){
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty StableVector");
+        return iterator(this, 0);
+    }
+
+
+    // Returns an iterator one element past the last element in the vector
+    [[nodiscard]] iterator end(){
+        return begin() + size();
+    }
+
+
+    // Returns a const iterator to the first element in the vector
+    [[nodiscard]] const_iterator cbegin() const {
+        if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty StableVector");
+        return const_iterator(this, 0);
+    }
+
+
+    // Returns a const iterator one element past the last element in the vector
+    [[nodiscard]] const_iterator cend() const {
+        return cbegin() + size();
+    }
+
+
+    // Returns a const iterator to the first element in the vector
+    [[nodiscard]] const_iterator begin() const {
+        return cbegin();
+    }
+
+
+    // Returns a const iterator one element past the last element in the vector
+    [[nodiscard]] const_iterator end() const {
+        return cend();
+    }
+
+
+    // Removes the last element in the vector
+    // Keeps its chunk allocated for the next push_back
+    void pop_back(){
+        if(empty()) throw std::out_of_range("Cannot remove element from empty vector");
+        --Size;
+        alloc_traits::destroy(alloc, &(*this)[size()]);
+    }
+
+
+    // Clear the vector
+    // Keeps the chunks allocated
+    void clear() noexcept {
+        destroy_range(0, size());
+        Size = 0;
+    }
+
+
+    // Frees the chunks no element lives in
+    // Capacity is a whole number of chunks, so it can stay above the size
+    void shrink_to_fit() noexcept {
+        free_chunks(chunks_for(size()));
+    }
+
+
+    // Allocates chunks until at least _size elements fit
+    // Only affects capacity
+    void reserve(const size_type _size){
+        while(capacity() < _size) add_chunk();
+    }
+
+
+    // Resizes the vector to _size elements
+    // Fills empty space with default values
+    void resize(const size_type _size){
+        if(_size <= size()){
+            destroy_range(_size, size());
+            Size = _size;
+            return;
+        }
+
+        reserve(_size);
+        for(; Size < _size; ++Size){
+            alloc_traits::construct(alloc, &(*this)[Size]);
+        }
+    }
+
+
+    // Returns the elements of chunk s as one contiguous span, so loops can run over plain arrays
+    // Chunk s starts at index FIRST_CHUNK * (2^s - 1), the span is empty past the last element
+    [[nodiscard]] std::span<T> chunk(const size_type s) noexcept {
+        if(s >= chunk_count()) return std::span<T>();
+        return std::span<T>(chunks[s], std::min(Layout::size_of(s), size() - Layout::start_of(s)));
+    }
+
+
+    // Returns the contiguous const elements of chunk s
+    [[nodiscard]] std::span<const T> chunk(const size_type s) const noexcept {
+        if(s >= chunk_count()) return std::span<const T>();
+        return std::span<const T>(chunks[s], std::min(Layout::size_of(s), size() - Layout::start_of(s)));
+    }
+
+
+    // Returns the number of chunks holding elements
+    [[nodiscard]] size_type chunk_count() const noexcept {
+        return chunks_for(size());
+    }
+
+
+    // Returns a copy of the allocator
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return alloc;
+    }
+
+
+    // Destructor
+    ~StableVector(){
+        release();
+    }
+};
+
+#endif
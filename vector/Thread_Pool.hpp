@@ -0,0 +1,174 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include "Vector.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+
+// A fixed set of worker threads that run fork-join jobs
+// A job is a number of chunks, every chunk is run exactly once by the caller or one of the workers
+class Thread_Pool{
+public:
+    typedef std::size_t size_type;
+private:
+
+    Vector<std::thread> workers;        // The helper threads, the caller of run() is the last participant
+    std::mutex submit;                  // Serializes jobs from different callers
+    std::mutex lock;                    // Guards the job state below
+    std::condition_variable wake;       // Workers wait on this for a new job
+    std::condition_variable done;       // The caller waits on this for the workers to finish
+    std::size_t generation;             // Incremented for every job
+    std::size_t finished;               // Workers done with the current job
+    bool stopping;                      // Tells the workers to exit
+
+    // The current job
+    void (*call)(void*, size_type, size_type);  // Runs one chunk of the job
+    void* context;                              // The callable of the job
+    size_type chunks;                           // Number of chunks in the job
+    std::atomic<size_type> next;                // The next chunk to hand out
+    std::exception_ptr error;                   // The first exception a chunk threw
+
+
+    // True on threads currently running chunks, so nested jobs run inline instead of deadlocking
+    static bool& inside_job() noexcept {
+        static thread_local bool inside = false;
+        return inside;
+    }
+
+
+    // Takes chunks of the current job until none are left
+    void work(const size_type participant) noexcept {
+        inside_job() = true;
+        for(size_type i = next.fetch_add(1, std::memory_order_relaxed); i < chunks; i = next.fetch_add(1, std::memory_order_relaxed)){
+            try{
+                call(context, i, participant);
+            }catch(...){
+                std::lock_guard<std::mutex> guard(lock);
+                if(!error) error = std::current_exception();
+                next.store(chunks, std::memory_order_relaxed);
+            }
+        }
+        inside_job() = false;
+    }
+
+
+    // Body of every worker thread
+    void worker_loop(const size_type participant){
+        size_type seen = 0;
+        std::unique_lock<std::mutex> guard(lock);
+        for(;;){
+            wake.wait(guard, [&]{ return stopping || generation != seen; });
+            if(stopping) return;
+            seen = generation;
+
+            guard.unlock();
+            work(participant);
+            guard.lock();
+
+            if(++finished == workers.size()) done.notify_one();
+        }
+    }
+
+
+    // Stops and joins every worker
+    void stop() noexcept {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for(size_type i = 0; i < workers.size(); ++i){
+            workers[i].join();
+        }
+    }
+
+
+    // Calls the callable behind context on one chunk
+    template<class F>
+    static void trampoline(void* context, const size_type chunk, const size_type participant){
+        (*static_cast<F*>(context))(chunk, participant);
+    }
+
+public:
+
+    // Starts a pool of threads participants, the thread calling run() counts as one of them
+    // Defaults to one participant per hardware thread
+    explicit Thread_Pool(const size_type threads = std::thread::hardware_concurrency()) :
+    generation{0}, finished{0}, stopping{false}, call{nullptr}, context{nullptr}, chunks{0}, next{0} {
+        const size_type helpers = threads > 1 ? threads - 1 : 0;
+        workers.reserve(helpers);
+        try{
+            for(size_type i = 0; i < helpers; ++i){
+                workers.emplace_back([this, i]{ worker_loop(i + 1); });
+            }
+        }catch(...){
+            stop();
+            throw;
+        }
+    }
+
+
+    // Pools own threads, so they can be neither copied nor moved
+    Thread_Pool(const Thread_Pool&) = delete;
+    Thread_Pool& operator=(const Thread_Pool&) = delete;
+
+
+    // Returns the number of participants in every job, including the caller
+    [[nodiscard]] size_type size() const noexcept {
+        return workers.size() + 1;
+    }
+
+
+    // Calls f(chunk, participant) for every chunk in [0, count) and waits for all of them
+    // participant is in [0, size()) and no two chunks run on the same participant at once
+    // Rethrows the first exception a chunk throws, chunks not yet started are then skipped
+    // Called from inside a chunk, the nested job runs inline on the calling thread
+    template<class F>
+    void run(const size_type count, F&& f){
+        if(count == 0) return;
+        if(workers.empty() || count == 1 || inside_job()){
+            for(size_type i = 0; i < count; ++i) f(i, size_type{0});
+            return;
+        }
+
+        std::lock_guard<std::mutex> serial(submit);
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            call = &trampoline<std::remove_reference_t<F>>;
+            context = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+            chunks = count;
+            next.store(0, std::memory_order_relaxed);
+            error = nullptr;
+            finished = 0;
+            ++generation;
+        }
+        wake.notify_all();
+
+        work(0);
+
+        std::unique_lock<std::mutex> guard(lock);
+        done.wait(guard, [this]{ return finished == workers.size(); });
+        call = nullptr;
+        context = nullptr;
+        if(error) std::rethrow_exception(std::exchange(error, nullptr));
+    }
+
+
+    // Destructor, stops and joins every worker
+    ~Thread_Pool(){
+        stop();
+    }
+};
+
+
+// The pool the parallel algorithms use unless they are given one, started on first use
+[[nodiscard]] inline Thread_Pool& default_pool(){
+    static Thread_Pool pool;
+    return pool;
+}
+
+#endif
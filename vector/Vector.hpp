@@ -4,194 +4,544 @@
 #include <utility>
 #include <memory>
 #include <stdexcept>
+#include <type_traits>
+#include <cstring>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <iterator>
+#include <algorithm>
+#include <initializer_list>
+#include <span>
+
+
+// True when moving a T to a new address and dropping the original is equivalent to a memcpy
+// Specialize this for types like std::unique_ptr that are relocatable without being trivially copyable
+template<class T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
 
+template<class T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
 
-// A simplified version of the stl vector
+
+// Detects an allocator construct() member that could do more than placement new
+// Containers only use memcpy for elements when the allocator does not customize construction
+template<class Allocator, class T, class = void>
+struct has_custom_construct : std::false_type {};
+
+template<class Allocator, class T>
+struct has_custom_construct<Allocator, T, std::void_t<decltype(std::declval<Allocator&>().construct(std::declval<T*>(), std::declval<T&&>()))>>
+: std::bool_constant<!std::is_same_v<Allocator, std::allocator<T>>> {};
+
+
+// An allocator backed by malloc/free which can grow a buffer in place through realloc
+// Vector uses reallocate() for trivially relocatable element types
 template<class T>
-class Vector{
-public:
-    typedef std::size_t size_type;
-private:
+struct Malloc_Allocator{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc cannot satisfy the alignment of T");
 
-    size_type Size;           // The Current number of elements in the vector
-    size_type Capacity;       // The total space allocated for the array
-    std::unique_ptr<T[]> uarr;  // The pointer for the array
+    typedef T value_type;
 
+    constexpr Malloc_Allocator() noexcept = default;
 
-    // Doubles the size of the underlying array when size reaches capacity
-    void grow(){
-        if(capacity() == 0) Capacity = 1;
-        std::unique_ptr<T[]> utemp(new T[capacity() * 2]{});
-        Capacity *= 2;
-        for(size_type i = 0; i < size(); ++i){
-            new(utemp.get() + i) T(std::move(uarr[i]));
-        }
+    template<class U>
+    constexpr Malloc_Allocator(const Malloc_Allocator<U>&) noexcept {}
+
+    // Allocates uninitialized space for n elements
+    [[nodiscard]] T* allocate(const std::size_t n){
+        if(n > std::size_t(-1) / sizeof(T)) throw std::bad_array_new_length();
+        void* p = std::malloc(n * sizeof(T));
+        if(p == nullptr && n != 0) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
 
-        uarr = std::move(utemp);
+    // Frees space returned by allocate() or reallocate()
+    void deallocate(T* p, const std::size_t) noexcept {
+        std::free(static_cast<void*>(p));
     }
 
+    // Resizes the block at p to new_n elements, moving the bytes if it cannot grow in place
+    [[nodiscard]] T* reallocate(T* p, const std::size_t, const std::size_t new_n){
+        if(new_n > std::size_t(-1) / sizeof(T)) throw std::bad_array_new_length();
+        void* temp = std::realloc(static_cast<void*>(p), new_n * sizeof(T));
+        if(temp == nullptr && new_n != 0) throw std::bad_alloc();
+        return static_cast<T*>(temp);
+    }
+
+    friend constexpr bool operator==(const Malloc_Allocator&, const Malloc_Allocator&) noexcept { return true; }
+    friend constexpr bool operator!=(const Malloc_Allocator&, const Malloc_Allocator&) noexcept { return false; }
+};
+
+
+// An allocator whose blocks start on an Alignment byte boundary and span whole multiples of Alignment
+// With 64 the array starts on a cache line and never shares a line with another allocation
+// Vector pads its capacity to whole multiples of Alignment and marks data() as aligned
+template<class T, std::size_t Alignment>
+struct Aligned_Allocator{
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must be at least the alignment of T");
+
+    static constexpr std::size_t alignment = Alignment;
+
+    typedef T value_type;
+
+    template<class U>
+    struct rebind{
+        typedef Aligned_Allocator<U, (Alignment > alignof(U) ? Alignment : alignof(U))> other;
+    };
+
+    constexpr Aligned_Allocator() noexcept = default;
+
+    template<class U, std::size_t A>
+    constexpr Aligned_Allocator(const Aligned_Allocator<U, A>&) noexcept {}
+
+    // Returns the number of bytes allocated for n elements
+    [[nodiscard]] static std::size_t aligned_size(const std::size_t n){
+        if(n > (std::size_t(-1) - Alignment) / sizeof(T)) throw std::bad_array_new_length();
+        return (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+    }
+
+    // Allocates uninitialized aligned space for n elements
+    [[nodiscard]] T* allocate(const std::size_t n){
+        return static_cast<T*>(::operator new(aligned_size(n), std::align_val_t(Alignment)));
+    }
+
+    // Frees space returned by allocate()
+    void deallocate(T* p, const std::size_t) noexcept {
+        ::operator delete(static_cast<void*>(p), std::align_val_t(Alignment));
+    }
+
+    friend constexpr bool operator==(const Aligned_Allocator&, const Aligned_Allocator&) noexcept { return true; }
+    friend constexpr bool operator!=(const Aligned_Allocator&, const Aligned_Allocator&) noexcept { return false; }
+};
+
+
+// The alignment every array from Allocator is guaranteed to have
+// Allocator::alignment when the allocator declares one, alignof its value_type otherwise
+template<class Allocator, class = void>
+struct allocator_alignment : std::integral_constant<std::size_t, alignof(typename Allocator::value_type)> {};
+
+template<class Allocator>
+struct allocator_alignment<Allocator, std::void_t<decltype(Allocator::alignment)>>
+: std::integral_constant<std::size_t, Allocator::alignment> {};
+
+template<class Allocator>
+inline constexpr std::size_t allocator_alignment_v = allocator_alignment<Allocator>::value;
+
+
+// Growth policies pick the capacity grow() reallocates to once the array is full
+// next<T>(capacity, required) must return a capacity of at least required
+
+
+// Multiplies the capacity by Num / Den, starting from two elements
+template<std::size_t Num, std::size_t Den>
+struct Ratio_Growth{
+    static_assert(Num > Den, "Growth ratio must be greater than one");
+
+    template<class T>
+    [[nodiscard]] static constexpr std::size_t next(const std::size_t capacity, const std::size_t required) noexcept {
+        std::size_t grown = capacity < 2 ? 2 : capacity / Den * Num + capacity % Den * Num / Den;
+        return grown < required ? required : grown;
+    }
+};
+
+// Doubles the capacity (the default)
+typedef Ratio_Growth<2, 1> Double_Growth;
+
+// Grows the capacity by half, so freed blocks can eventually be reused by later growth
+typedef Ratio_Growth<3, 2> Half_Growth;
+
+
+// Grows by half, then rounds up so the array fills the whole chunk glibc malloc hands out
+// Small chunks are multiples of 16 bytes with an 8 byte header, chunks past the mmap threshold are whole pages
+struct Size_Class_Growth{
+    static constexpr std::size_t MMAP_THRESHOLD = 128 * 1024;
+    static constexpr std::size_t PAGE_SIZE = 4096;
+
+    // Returns the usable size of the chunk malloc would return for a request of bytes
+    [[nodiscard]] static constexpr std::size_t usable_size(const std::size_t bytes) noexcept {
+        if(bytes + 16 >= MMAP_THRESHOLD) return (bytes + 16 + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE - 16;
+        const std::size_t chunk = (bytes + 8 + 15) / 16 * 16;
+        return (chunk < 32 ? 32 : chunk) - 8;
+    }
+
+    template<class T>
+    [[nodiscard]] static constexpr std::size_t next(const std::size_t capacity, const std::size_t required) noexcept {
+        std::size_t grown = Half_Growth::next<T>(capacity, required);
+        return usable_size(grown * sizeof(T)) / sizeof(T);
+    }
+};
+
+
+// Doubles the capacity until it reaches Step elements, then adds Step elements at a time
+// Bounds the unused memory of huge arrays to Step elements
+template<std::size_t Step>
+struct Fixed_Step_Growth{
+    static_assert(Step > 0, "Growth step must be positive");
+
+    template<class T>
+    [[nodiscard]] static constexpr std::size_t next(const std::size_t capacity, const std::size_t required) noexcept {
+        std::size_t grown = capacity < Step ? Double_Growth::next<T>(capacity, required) : capacity + Step;
+        return grown < required ? required : grown;
+    }
+};
+
+
+// Random access iterator for traversing contiguous containers (Vector and its variants)
+template<class Access_Type>
+class Vector_Iterator{
+public:
+    // Iterator traits to make the iterator stl compliant
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Access_Type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Access_Type*;
+    using reference = Access_Type&;
+
+
 protected:
+    Access_Type* elt; // A pointer to a given element in a vector
 
-    // Bidirectional iterator for traversing the vector
-    template<class Access_Type>
-    class IteratorType{
-        friend class Vector;
-    public:
-        // Iterator traits to make the iterator stl compliant
-        using iterator_category = std::random_access_iterator_tag;
-        using value_type = Access_Type;
-        using difference_type = std::ptrdiff_t;
-        using pointer = Access_Type*;
-        using reference = Access_Type&;
+public:
+    // Simple contructor
+    constexpr Vector_Iterator(Access_Type* val) noexcept : elt{val} {};
 
 
-    protected:
-        Access_Type* elt; // A pointer to a given element in a vector
+    // Dereference operator overload
+    [[nodiscard]] constexpr Access_Type& operator*() const noexcept {
+        return *elt;
+    }
 
-    public:
-        // Simple contructor
-        IteratorType(Access_Type* val) noexcept : elt{val} {};
 
+    // Dereference operator overload
+    [[nodiscard]] constexpr Access_Type* operator->() const noexcept {
+        return elt;
+    }
 
-        // Dereference operator overload
-        [[nodiscard]] Access_Type& operator*() const noexcept {
-            return *elt;
-        }
 
+    // Access operator
+    constexpr Access_Type& operator[](const std::size_t& i) noexcept {
+        return *(elt + i);
+    }
+    constexpr Access_Type& operator[](std::size_t&& i) noexcept {
+        return *(elt + std::move(i));
+    }
+    constexpr const Access_Type& operator[](const std::size_t& i) const noexcept {
+        return *(elt + i);
+    }
+    constexpr const Access_Type& operator[](std::size_t&& i) const noexcept {
+        return *(elt + std::move(i));
+    }
 
-        // Dereference operator overload
-        [[nodiscard]] Access_Type* operator->() const noexcept {
-            return *elt;
-        }
 
+    // Prefix increment
+    constexpr Vector_Iterator<Access_Type>& operator++() noexcept {
+        ++elt;
+        return *this;
+    }
 
-        // Access operator
-        Access_Type& operator[](const size_type& i) noexcept {
-            return *(elt + i);
-        }
-        Access_Type& operator[](size_type&& i) noexcept {
-            return *(elt + std::move(i));
-        }
-        const Access_Type& operator[](const size_type& i) const noexcept {
-            return *(elt + i);
-        }
-        const Access_Type& operator[](size_type&& i) const noexcept {
-            return *(elt + std::move(i));
-        }
 
+    // Postfix increment
+    constexpr Vector_Iterator<Access_Type> operator++(int) noexcept {
+        Vector_Iterator<Access_Type> temp(elt);
+        ++elt;
+        return temp;
+    }
 
-        // Prefix increment
-        IteratorType<Access_Type>& operator++() noexcept {
-            ++elt;
-            return *this;
-        }
 
+    // Prefix decrement
+    constexpr Vector_Iterator<Access_Type>& operator--() noexcept {
+        --elt;
+        return *this;
+    }
 
-        // Postfix increment
-        IteratorType<Access_Type> operator++(int) noexcept {
-            IteratorType<Access_Type> temp(elt);
-            ++elt;
-            return temp;
-        }
 
+    // Postfix decrement
+    constexpr Vector_Iterator<Access_Type> operator--(int) noexcept {
+        Vector_Iterator<Access_Type> temp(elt);
+        --elt;
+        return temp;
+    }
 
-        // Prefix decrement
-        IteratorType<Access_Type>& operator--() noexcept {
-            --elt;
-            return *this;
-        }
 
+    // Compound Assignments
+    constexpr Vector_Iterator<Access_Type>& operator+=(const std::size_t& offset) noexcept {
+        elt += offset;
+        return *this;
+    }
+    constexpr Vector_Iterator<Access_Type>& operator+=(std::size_t&& offset) noexcept {
+        elt += std::move(offset);
+        return *this;
+    }
+    constexpr Vector_Iterator<Access_Type>& operator-=(const std::size_t& offset) noexcept {
+        elt -= offset;
+        return *this;
+    }
+    constexpr Vector_Iterator<Access_Type>& operator-=(std::size_t&& offset) noexcept {
+        elt -= std::move(offset);
+        return *this;
+    }
 
-        // Postfix decrement
-        IteratorType<Access_Type> operator--(int) noexcept {
-            IteratorType<Access_Type> temp(elt);
-            --elt;
-            return temp;
-        }
 
+    // Addition
+    [[nodiscard]] friend constexpr Vector_Iterator<Access_Type> operator+(Vector_Iterator<Access_Type> it, const std::size_t& offset) noexcept {
+        return std::move(it += offset);
+    }
+    [[nodiscard]] friend constexpr Vector_Iterator<Access_Type> operator+(Vector_Iterator<Access_Type> it, std::size_t&& offset) noexcept {
+        return std::move(it += std::move(offset));
+    }
+    [[nodiscard]] friend constexpr Vector_Iterator<Access_Type> operator+(const std::size_t& offset, Vector_Iterator<Access_Type> it) noexcept {
+        return std::move(it += offset);
+    }
+    [[nodiscard]] friend constexpr Vector_Iterator<Access_Type> operator+(std::size_t&& offset, Vector_Iterator<Access_Type> it) noexcept {
+        return std::move(it += std::move(offset));
+    }
 
-        // Compound Assignments
-        IteratorType<Access_Type>& operator+=(const size_type& offset) noexcept {
-            elt += offset;
-            return *this;
-        }
-        IteratorType<Access_Type>& operator+=(size_type&& offset) noexcept {
-            elt += std::move(offset);
-            return *this;
-        }
-        IteratorType<Access_Type>& operator-=(const size_type& offset) noexcept {
-            elt -= offset;
-            return *this;
-        }
-        IteratorType<Access_Type>& operator-=(size_type&& offset) noexcept {
-            elt -= std::move(offset);
-            return *this;
-        }
 
+    // Subtraction
+    [[nodiscard]] friend constexpr Vector_Iterator<Access_Type> operator-(Vector_Iterator<Access_Type> it, const std::size_t& offset) noexcept {
+        return std::move(it -= offset);
+    }
+    [[nodiscard]] friend constexpr Vector_Iterator<Access_Type> operator-(Vector_Iterator<Access_Type> it, std::size_t&& offset) noexcept {
+        return std::move(it -= std::move(offset));
+    }
+    [[nodiscard]] friend constexpr Vector_Iterator<Access_Type> operator-(const std::size_t& offset, Vector_Iterator<Access_Type> it) noexcept {
+        return std::move(it -= offset);
+    }
+    [[nodiscard]] friend constexpr Vector_Iterator<Access_Type> operator-(std::size_t&& offset, Vector_Iterator<Access_Type> it) noexcept {
+        return std::move(it -= std::move(offset));
+    }
 
-        // Addition
-        [[nodiscard]] friend IteratorType<Access_Type> operator+(IteratorType<Access_Type> it, const size_type& offset) noexcept {
-            return std::move(it += offset);
-        }
-        [[nodiscard]] friend IteratorType<Access_Type> operator+(IteratorType<Access_Type> it, size_type&& offset) noexcept {
-            return std::move(it += std::move(offset));
-        }
-        [[nodiscard]] friend IteratorType<Access_Type> operator+(const size_type& offset, IteratorType<Access_Type> it) noexcept {
-            return std::move(it += offset);
-        }
-        [[nodiscard]] friend IteratorType<Access_Type> operator+(size_type&& offset, IteratorType<Access_Type> it) noexcept {
-            return std::move(it += std::move(offset));
-        }
 
+    [[nodiscard]] constexpr difference_type operator-(const Vector_Iterator<Access_Type>& other) const noexcept {
+        return static_cast<difference_type>(elt - other.elt);
+    }
 
-        // Subtraction
-        [[nodiscard]] friend IteratorType<Access_Type> operator-(IteratorType<Access_Type> it, const size_type& offset) noexcept {
-            return std::move(it -= offset);
-        }
-        [[nodiscard]] friend IteratorType<Access_Type> operator-(IteratorType<Access_Type> it, size_type&& offset) noexcept {
-            return std::move(it -= std::move(offset));
+
+    // Equality operator overload
+    // Checks that the two iterators point to the same object
+    [[nodiscard]] friend constexpr bool operator==(const Vector_Iterator<Access_Type>& left, const Vector_Iterator<Access_Type>& right) noexcept {
+        return left.elt == right.elt;
+    }
+
+
+    // Inequality operator overload
+    // Checks that the two iterators point to different objects
+    [[nodiscard]] friend constexpr bool operator!=(const Vector_Iterator<Access_Type>& left, const Vector_Iterator<Access_Type>& right) noexcept {
+        return left.elt != right.elt;
+    }
+
+
+    // Comparison operators
+    [[nodiscard]] constexpr bool operator<(const Vector_Iterator<Access_Type>& other) const noexcept {
+        return elt < other.elt;
+    }
+    [[nodiscard]] constexpr bool operator<=(const Vector_Iterator<Access_Type>& other) const noexcept {
+        return elt <= other.elt;
+    }
+    [[nodiscard]] constexpr bool operator>(const Vector_Iterator<Access_Type>& other) const noexcept {
+        return elt > other.elt;
+    }
+    [[nodiscard]] constexpr bool operator>=(const Vector_Iterator<Access_Type>& other) const noexcept {
+        return elt >= other.elt;
+    }
+};
+
+
+// A simplified version of the stl vector
+// Storage is obtained uninitialized from Allocator, so only live elements are ever constructed
+template<class T, class Allocator = std::allocator<T>, class GrowthPolicy = Double_Growth>
+class Vector{
+public:
+    typedef std::size_t size_type;
+    typedef Allocator allocator_type;
+    typedef GrowthPolicy growth_policy;
+private:
+    typedef std::allocator_traits<Allocator> alloc_traits;
+
+
+    // Detects an allocator that can resize a block without a separate allocate and copy
+    template<class A, class = void>
+    struct can_reallocate : std::false_type {};
+    template<class A>
+    struct can_reallocate<A, std::void_t<decltype(std::declval<A&>().reallocate(std::declval<T*>(), size_type{}, size_type{}))>>
+    : std::true_type {};
+
+    // Elements may be moved with memcpy instead of constructor calls
+    static constexpr bool memcpy_relocate = is_trivially_relocatable_v<T> && !has_custom_construct<Allocator, T>::value;
+
+    // Elements may be copied with memcpy instead of constructor calls
+    static constexpr bool memcpy_copy = std::is_trivially_copyable_v<T> && !has_custom_construct<Allocator, T>::value;
+
+    // The alignment of arr, data() tells the compiler about it
+    static constexpr size_type ALIGNMENT = allocator_alignment_v<Allocator>;
+
+    // Capacities are padded to whole multiples of this many elements, so an aligned array also ends aligned
+    // and vectorized loops over the capacity need no scalar tail
+    static constexpr size_type PADDING = ALIGNMENT > alignof(T) && ALIGNMENT % sizeof(T) == 0 ? ALIGNMENT / sizeof(T) : 1;
+
+    size_type Size;           // The Current number of elements in the vector
+    size_type Capacity;       // The total space allocated for the array
+    T* arr;                   // The pointer for the (partially uninitialized) array
+    Allocator alloc;          // The allocator used for the array and its elements
+
+
+    // Destroys the elements in [first, last) without releasing memory
+    void destroy_range(const size_type first, const size_type last) noexcept {
+        for(size_type i = first; i < last; ++i){
+            alloc_traits::destroy(alloc, arr + i);
         }
-        [[nodiscard]] friend IteratorType<Access_Type> operator-(const size_type& offset, IteratorType<Access_Type> it) noexcept {
-            return std::move(it -= offset);
+    }
+
+
+    // Destroys every element and releases the array
+    void release() noexcept {
+        destroy_range(0, size());
+        if(arr != nullptr) alloc_traits::deallocate(alloc, arr, capacity());
+        arr = nullptr;
+        Size = 0;
+        Capacity = 0;
+    }
+
+
+    // Rounds a capacity up to a whole multiple of PADDING
+    [[nodiscard]] static constexpr size_type padded(const size_type capacity) noexcept {
+        return (capacity + PADDING - 1) / PADDING * PADDING;
+    }
+
+
+    // Moves the first count elements into a fresh array of at least min_capacity slots
+    // Only the moved elements are constructed, the rest of the array stays raw
+    void reallocate(const size_type min_capacity, const size_type count){
+        const size_type new_capacity = padded(min_capacity);
+        if constexpr(memcpy_relocate){
+            destroy_range(count, size());
+            if constexpr(can_reallocate<Allocator>::value){
+                // The allocator may extend the block in place, otherwise it copies the bytes itself
+                arr = alloc.reallocate(arr, capacity(), new_capacity);
+            }else{
+                T* temp = alloc_traits::allocate(alloc, new_capacity);
+                if(count > 0) std::memcpy(static_cast<void*>(temp), static_cast<const void*>(arr), count * sizeof(T));
+                if(arr != nullptr) alloc_traits::deallocate(alloc, arr, capacity());
+                arr = temp;
+            }
+            Capacity = new_capacity;
+            return;
         }
-        [[nodiscard]] friend IteratorType<Access_Type> operator-(size_type&& offset, IteratorType<Access_Type> it) noexcept {
-            return std::move(it -= std::move(offset));
+
+        T* temp = alloc_traits::allocate(alloc, new_capacity);
+        size_type i = 0;
+        try{
+            for(; i < count; ++i){
+                alloc_traits::construct(alloc, temp + i, std::move_if_noexcept(arr[i]));
+            }
+        }catch(...){
+            for(size_type j = 0; j < i; ++j) alloc_traits::destroy(alloc, temp + j);
+            alloc_traits::deallocate(alloc, temp, new_capacity);
+            throw;
         }
 
+        destroy_range(0, size());
+        if(arr != nullptr) alloc_traits::deallocate(alloc, arr, capacity());
+        arr = temp;
+        Capacity = new_capacity;
+    }
 
-        [[nodiscard]] difference_type operator-(const IteratorType<Access_Type>& other) const noexcept {
-            return static_cast<difference_type>(elt - other.elt);
-        }
 
+    // Grows the underlying array by GrowthPolicy when size reaches capacity
+    void grow(){
+        reallocate(GrowthPolicy::template next<T>(capacity(), size() + 1), size());
+    }
 
-        // Equality operator overload
-        // Checks that the two iterators point to the same object
-        [[nodiscard]] friend bool operator==(const IteratorType<Access_Type>& left, const IteratorType<Access_Type>& right) noexcept {
-            return left.elt == right.elt;
-        }
 
+    // Makes room for count more elements with at most one reallocation
+    void grow_for(const size_type count){
+        if(size() + count > capacity()) reallocate(GrowthPolicy::template next<T>(capacity(), size() + count), size());
+    }
 
-        // Inequality operator overload
-        // Checks that the two iterators point to different objects
-        [[nodiscard]] friend bool operator!=(const IteratorType<Access_Type>& left, const IteratorType<Access_Type>& right) noexcept {
-            return left.elt != right.elt;
-        }
 
+    // True when It walks a contiguous array of T, so a range can be copied with memcpy
+    template<class It>
+    static constexpr bool contiguous_source = (std::is_pointer_v<It> && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<It>>, T>)
+                                           || std::is_same_v<It, Vector_Iterator<T>> || std::is_same_v<It, Vector_Iterator<const T>>;
 
-        // Comparison operators
-        [[nodiscard]] bool operator<(const IteratorType<Access_Type>& other) const noexcept {
-            return elt < other.elt;
-        }
-        [[nodiscard]] bool operator<=(const IteratorType<Access_Type>& other) const noexcept {
-            return elt <= other.elt;
+
+    // True when It can be traversed more than once, so the length of a range is known up front
+    template<class It>
+    static constexpr bool forward_source = std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>;
+
+
+    // Constructs copies of [first, first + count) at the back
+    // REQUIRES size() + count <= capacity()
+    template<class ForwardIt>
+    void construct_back(ForwardIt first, const size_type count){
+        if constexpr(memcpy_copy && contiguous_source<ForwardIt>){
+            if(count > 0) std::memcpy(static_cast<void*>(arr + size()), static_cast<const void*>(&*first), count * sizeof(T));
+            Size += count;
+        }else{
+            for(size_type i = 0; i < count; ++i, ++first){
+                alloc_traits::construct(alloc, arr + size(), *first);
+                ++Size;
+            }
         }
-        [[nodiscard]] bool operator>(const IteratorType<Access_Type>& other) const noexcept {
-            return elt > other.elt;
+    }
+
+
+    // Default-initializes count elements at the back, which is a no-op for trivial types
+    // REQUIRES size() + count <= capacity()
+    void default_init_back(const size_type count){
+        if constexpr(std::is_trivially_default_constructible_v<T>){
+            Size += count;
+        }else{
+            for(size_type i = 0; i < count; ++i){
+                ::new(static_cast<void*>(arr + size())) T;
+                ++Size;
+            }
         }
-        [[nodiscard]] bool operator>=(const IteratorType<Access_Type>& other) const noexcept {
-            return elt >= other.elt;
+    }
+
+
+    // Inserts count elements at pos, which fill(count) constructs at the back of the vector
+    // Trivially relocatable elements are shifted with memmove, anything else is rotated into place
+    // If fill throws, the vector is left unchanged
+    template<class Fill>
+    void insert_with(const size_type pos, const size_type count, Fill&& fill){
+        if(pos > size()) throw std::out_of_range("Cannot insert outside of the vector");
+        if(count == 0) return;
+        grow_for(count);
+
+        const size_type old_size = size();
+        if constexpr(memcpy_relocate){
+            // Open a raw gap at pos and hide the tail so fill() constructs straight into the gap
+            const size_type tail = old_size - pos;
+            if(tail > 0) std::memmove(static_cast<void*>(arr + pos + count), static_cast<const void*>(arr + pos), tail * sizeof(T));
+            Size = pos;
+            try{
+                fill(count);
+            }catch(...){
+                destroy_range(pos, size());
+                std::memmove(static_cast<void*>(arr + pos), static_cast<const void*>(arr + pos + count), tail * sizeof(T));
+                Size = old_size;
+                throw;
+            }
+            Size += tail;
+        }else{
+            try{
+                fill(count);
+            }catch(...){
+                destroy_range(old_size, size());
+                Size = old_size;
+                throw;
+            }
+            std::rotate(arr + pos, arr + old_size, arr + size());
         }
-    };
+    }
+
+protected:
+
+    // Shared with the other containers in this module
+    template<class Access_Type>
+    using IteratorType = Vector_Iterator<Access_Type>;
 
 
 public:
@@ -206,66 +556,113 @@ public:
 
 
     // Default constructor
-    constexpr Vector() noexcept :
-    Size{0}, Capacity{0}, uarr{nullptr} {}
+    constexpr Vector() noexcept(noexcept(Allocator())) :
+    Size{0}, Capacity{0}, arr{nullptr}, alloc{} {}
+
+
+    // Allocator constructor
+    explicit constexpr Vector(const Allocator& _alloc) noexcept :
+    Size{0}, Capacity{0}, arr{nullptr}, alloc{_alloc} {}
 
 
     // Size constructor with default value
-    Vector(const size_type _size) noexcept :
-    Size{_size}, Capacity{_size}, uarr{new T[_size]{}} {}
+    // If a constructor throws, the elements built so far are destroyed and the array is freed
+    explicit Vector(const size_type _size, const Allocator& _alloc = Allocator()) :
+    Size{0}, Capacity{0}, arr{nullptr}, alloc{_alloc} {
+        try{
+            reserve(_size);
+            for(; Size < _size; ++Size){
+                alloc_traits::construct(alloc, arr + Size);
+            }
+        }catch(...){
+            release();
+            throw;
+        }
+    }
 
 
     // Size constructor with given value
-    Vector(const size_type _size, const T& elt) :
-    Size{0}, Capacity{_size}, uarr{new T[_size]} {
-        for(size_type _ = 0; _ < _size; ++_){
-            push_back(elt);
+    // If a copy throws, the elements built so far are destroyed and the array is freed
+    Vector(const size_type _size, const T& elt, const Allocator& _alloc = Allocator()) :
+    Size{0}, Capacity{0}, arr{nullptr}, alloc{_alloc} {
+        try{
+            reserve(_size);
+            for(size_type _ = 0; _ < _size; ++_){
+                push_back(elt);
+            }
+        }catch(...){
+            release();
+            throw;
+        }
+    }
+
+
+    // Initializer list constructor
+    // If a copy throws, the elements built so far are destroyed and the array is freed
+    Vector(std::initializer_list<T> list, const Allocator& _alloc = Allocator()) :
+    Size{0}, Capacity{0}, arr{nullptr}, alloc{_alloc} {
+        try{
+            assign(list);
+        }catch(...){
+            release();
+            throw;
         }
     }
 
 
     // Copy constructor
-    Vector(const Vector<T>& other) noexcept :
-    Size{other.size()}, Capacity{other.capacity()}, uarr{new T[other.capacity()]} {
-        std::copy(other.begin(), other.end(), begin());
+    // If a copy throws, the elements built so far are destroyed and the array is freed
+    Vector(const Vector& other) :
+    Size{0}, Capacity{0}, arr{nullptr},
+    alloc{alloc_traits::select_on_container_copy_construction(other.alloc)} {
+        reserve(other.capacity());
+        if constexpr(memcpy_copy){
+            if(!other.empty()) std::memcpy(static_cast<void*>(arr), static_cast<const void*>(other.arr), other.size() * sizeof(T));
+            Size = other.size();
+            return;
+        }
+        try{
+            for(; Size < other.size(); ++Size){
+                alloc_traits::construct(alloc, arr + Size, other[Size]);
+            }
+        }catch(...){
+            release();
+            throw;
+        }
     }
 
 
     // Move constructor
-    Vector(Vector<T>&& other) noexcept :
-    Size{0}, Capacity{0}, uarr{std::move(other.uarr)} {
-        std::swap(Size, other.Size);
-        std::swap(Capacity, other.Capacity);
+    Vector(Vector&& other) noexcept :
+    Size{other.Size}, Capacity{other.Capacity}, arr{other.arr}, alloc{std::move(other.alloc)} {
+        other.arr = nullptr;
+        other.Size = 0;
+        other.Capacity = 0;
     }
 
 
     // Copy assignment
-    Vector<T>& operator=(const Vector<T>& other) noexcept {
+    Vector& operator=(const Vector& other){
         // Guard self assignment
-        if(this->uarr == other.uarr) return *this;
+        if(this == &other) return *this;
 
-        uarr.reset(new T[other.capacity()]);
-        Size = other.size();
-        Capacity = other.capacity();
-        std::copy(other.begin(), other.end(), begin());
+        Vector temp(other);
+        *this = std::move(temp);
 
         return *this;
     }
 
 
     // Move assignment
-    Vector<T>& operator=(Vector<T>&& other) noexcept {
+    Vector& operator=(Vector&& other) noexcept {
         // Guard self assignment
-        if(this->uarr == other.uarr) return *this;
+        if(this == &other) return *this;
 
-        if(uarr != nullptr){
-            uarr = nullptr;
-            Size = 0;
-            Capacity = 0;
-        }
+        release();
         std::swap(Size, other.Size);
         std::swap(Capacity, other.Capacity);
-        uarr.swap(other.uarr);
+        std::swap(arr, other.arr);
+        std::swap(alloc, other.alloc);
         return *this;
     }
 
@@ -274,7 +671,7 @@ public:
     template<class... Args>
     void emplace_back(Args&&... args){
         if(size() == capacity()) grow();
-        new(uarr.get() + size()) T(std::forward<Args>(args)...);
+        alloc_traits::construct(alloc, arr + size(), std::forward<Args>(args)...);
         ++Size;
     }
 
@@ -291,6 +688,165 @@ public:
     }
 
 
+    // Copies [first, last) to the back of the vector with a single reallocation
+    // first and last must not point into this vector
+    template<class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+    void append(InputIt first, InputIt last){
+        if constexpr(forward_source<InputIt>){
+            const size_type count = static_cast<size_type>(std::distance(first, last));
+            const size_type old_size = size();
+            grow_for(count);
+            try{
+                construct_back(first, count);
+            }catch(...){
+                destroy_range(old_size, size());
+                Size = old_size;
+                throw;
+            }
+        }else{
+            for(; first != last; ++first){
+                emplace_back(*first);
+            }
+        }
+    }
+
+
+    // Copies the list to the back of the vector with a single reallocation
+    void append(std::initializer_list<T> list){
+        append(list.begin(), list.end());
+    }
+
+
+    // Creates an element in place before index pos
+    // Throws std::out_of_range when pos > size()
+    template<class... Args>
+    void emplace(const size_type pos, Args&&... args){
+        // Built first, since args may refer to elements that are about to move
+        T elt(std::forward<Args>(args)...);
+        insert_with(pos, 1, [&](size_type){
+            alloc_traits::construct(alloc, arr + size(), std::move(elt));
+            ++Size;
+        });
+    }
+
+
+    // Inserts a copy of elt before index pos
+    void insert(const size_type pos, const T& elt){
+        emplace(pos, elt);
+    }
+
+
+    // Moves elt in before index pos
+    void insert(const size_type pos, T&& elt){
+        emplace(pos, std::move(elt));
+    }
+
+
+    // Inserts count copies of elt before index pos
+    void insert(const size_type pos, const size_type count, const T& elt){
+        // Copied first, since elt may be an element that is about to move
+        const T copy(elt);
+        insert_with(pos, count, [&](const size_type n){
+            for(size_type i = 0; i < n; ++i){
+                alloc_traits::construct(alloc, arr + size(), copy);
+                ++Size;
+            }
+        });
+    }
+
+
+    // Inserts copies of [first, last) before index pos with at most one reallocation
+    // first and last must not point into this vector
+    template<class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+    void insert(const size_type pos, InputIt first, InputIt last){
+        if constexpr(forward_source<InputIt>){
+            insert_with(pos, static_cast<size_type>(std::distance(first, last)), [&](const size_type n){
+                construct_back(first, n);
+            });
+        }else{
+            // Single pass ranges are gathered first so their length is known
+            Vector temp(alloc);
+            temp.append(first, last);
+            insert(pos, std::make_move_iterator(temp.arr), std::make_move_iterator(temp.arr + temp.size()));
+        }
+    }
+
+
+    // Inserts copies of the list before index pos
+    void insert(const size_type pos, std::initializer_list<T> list){
+        insert(pos, list.begin(), list.end());
+    }
+
+
+    // Removes the elements at indices [first, last)
+    // Throws std::out_of_range when the range is not inside the vector
+    void erase(const size_type first, const size_type last){
+        if(first > last || last > size()) throw std::out_of_range("Cannot erase outside of the vector");
+        if(first == last) return;
+
+        if constexpr(memcpy_relocate){
+            const size_type tail = size() - last;
+            destroy_range(first, last);
+            if(tail > 0) std::memmove(static_cast<void*>(arr + first), static_cast<const void*>(arr + last), tail * sizeof(T));
+        }else{
+            std::move(arr + last, arr + size(), arr + first);
+            destroy_range(size() - (last - first), size());
+        }
+        Size -= last - first;
+    }
+
+
+    // Removes the element at index pos
+    void erase(const size_type pos){
+        erase(pos, pos + 1);
+    }
+
+
+    // Replaces the contents with count copies of elt
+    void assign(const size_type count, const T& elt){
+        // Copied first, since elt may be an element that is about to be destroyed
+        const T copy(elt);
+        clear();
+        if(count > capacity()) reallocate(count, 0);
+        for(; Size < count; ++Size){
+            alloc_traits::construct(alloc, arr + Size, copy);
+        }
+    }
+
+
+    // Replaces the contents with copies of [first, last)
+    // first and last must not point into this vector
+    template<class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt first, InputIt last){
+        clear();
+        if constexpr(forward_source<InputIt>){
+            const size_type count = static_cast<size_type>(std::distance(first, last));
+            if(count > capacity()) reallocate(count, 0);
+            try{
+                construct_back(first, count);
+            }catch(...){
+                clear();
+                throw;
+            }
+        }else{
+            append(first, last);
+        }
+    }
+
+
+    // Replaces the contents with copies of the list
+    void assign(std::initializer_list<T> list){
+        assign(list.begin(), list.end());
+    }
+
+
+    // Replaces the contents with copies of the list
+    Vector& operator=(std::initializer_list<T> list){
+        assign(list);
+        return *this;
+    }
+
+
     // Returns the size of the vector
     [[nodiscard]] constexpr size_type size() const noexcept {
         return Size;
@@ -312,14 +868,14 @@ public:
     // Returns a reference to the indexed element
     [[nodiscard]] T& at(const size_type i){
         if(i >= size()) throw std::out_of_range("Indexed out of range");
-        return uarr[i];
+        return arr[i];
     }
 
 
     // Returns a const reference to the indexed element
     [[nodiscard]] const T& at(const size_type i) const {
         if(i >= size()) throw std::out_of_range("Indexed out of range");
-        return uarr[i];
+        return arr[i];
     }
 
 
@@ -351,41 +907,41 @@ public:
 
     // Operator overload to allow direct indexing
     [[nodiscard]] T& operator[](const size_type i) noexcept {
-        return uarr[i];
+        return arr[i];
     }
 
 
     // Operator overload to allow direct const indexing
     [[nodiscard]] const T& operator[](const size_type i) const noexcept {
-        return uarr[i];
+        return arr[i];
     }
 
 
     // Returns an iterator to the first element in the vector
     [[nodiscard]] iterator begin() const {
         if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty Vector");
-        return iterator(uarr.get());
+        return iterator(arr);
     }
 
 
     // Returns an iterator one element past the last element in the vector
     [[nodiscard]] iterator end() const {
         if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty Vector");
-        return iterator(uarr.get() + size());
+        return iterator(arr + size());
     }
 
 
     // Returns a const iterator to the first element in the vector
     [[nodiscard]] const_iterator cbegin() const {
         if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty Vector");
-        return const_iterator(uarr.get());
+        return const_iterator(arr);
     }
 
 
     // Returns a const iterator one element past the last element in the vector
     [[nodiscard]] const_iterator cend() const {
         if(empty()) throw std::out_of_range("Cannot create an Iterator of an empty Vector");
-        return const_iterator(uarr.get() + size());
+        return const_iterator(arr + size());
     }
 
 
@@ -393,75 +949,113 @@ public:
     void pop_back(){
         if(empty()) throw std::out_of_range("Cannot remove element from empty vector");
         --Size;
-        std::destroy_at(uarr.get() + size());
+        alloc_traits::destroy(alloc, arr + size());
     }
 
 
     // Clear the vector
-    void clear(){
-        while(!empty()) pop_back();
+    void clear() noexcept {
+        destroy_range(0, size());
+        Size = 0;
     }
 
 
     // Shrinks the internal array to the number of elements in the vector
-    void shrink_to_fit() noexcept {
-        if(capacity() == size()) return;
+    // Aligned allocators keep the capacity padded to a whole multiple of their alignment
+    void shrink_to_fit(){
+        if(capacity() == padded(size())) return;
 
         if(empty()){
-            uarr = nullptr;
-            Capacity = 0;
+            release();
             return;
         }
 
-        std::unique_ptr<T[]> utemp(new T[size()]);
-        for(size_type i = 0; i < size(); ++i){
-            new(utemp.get() + i) T(std::move(uarr[i]));
-        }
-        Capacity = size();
-
-        uarr = std::move(utemp);
+        reallocate(size(), size());
     }
 
 
     // Allocates at least _size elements in of space
     // Only affects capacity
-    void reserve(const size_type _size) noexcept {
+    void reserve(const size_type _size){
         if(_size <= capacity()) return;
 
-        std::unique_ptr<T[]> utemp(new T[_size]);
-        for(size_type i = 0; i < size(); ++i){
-            new(utemp.get() + i) T(std::move(uarr[i]));
-        }
-        Capacity = _size;
-
-        uarr = std::move(utemp);
+        reallocate(_size, size());
     }
 
 
-    // Resizes the underlying array to _size
+    // Resizes the vector to _size elements
     // Fills empty space with default values
-    void resize(const size_type _size) noexcept {
-        if(_size == size()) return;
+    // Reuses the current capacity, only reallocating (to exactly _size) when _size > capacity()
+    void resize(const size_type _size){
+        if(_size <= size()){
+            destroy_range(_size, size());
+            Size = _size;
+            return;
+        }
 
-        std::unique_ptr<T[]> utemp(new T[_size]{});
-        for(size_type i = 0; i < (_size < size() ? _size : size()); ++i){
-            new(utemp.get() + i) T(std::move(uarr[i]));
+        reserve(_size);
+        for(; Size < _size; ++Size){
+            alloc_traits::construct(alloc, arr + Size);
         }
-        uarr = std::move(utemp);
-        Size = _size;
-        Capacity = _size;
+    }
+
+
+    // Resizes the vector to _size elements, default-initializing any new ones
+    // New trivially default constructible elements are left uninitialized, ready to be overwritten
+    // Reuses the current capacity, only reallocating (to exactly _size) when _size > capacity()
+    void resize_for_overwrite(const size_type _size){
+        if(_size <= size()){
+            destroy_range(_size, size());
+            Size = _size;
+            return;
+        }
+
+        reserve(_size);
+        default_init_back(_size - size());
+    }
+
+
+    // Adds count default-initialized elements to the back and returns them
+    // For trivially default constructible types the slots are uninitialized, so readers can fill them directly
+    // Grows through GrowthPolicy with at most one reallocation
+    [[nodiscard]] std::span<T> append_uninitialized(const size_type count){
+        grow_for(count);
+        const size_type first = size();
+        default_init_back(count);
+        return std::span<T>(arr + first, count);
     }
 
 
     // Returns a pointer to the underlying array
     // Assumes class invariants will not be invalidated.
+    // The pointer is known to the compiler to be aligned to the allocator's alignment
     [[nodiscard]] T* data() noexcept {
-        return uarr.get();
+        return std::assume_aligned<ALIGNMENT>(arr);
+    }
+
+
+    // Returns a const pointer to the underlying array
+    [[nodiscard]] const T* data() const noexcept {
+        return std::assume_aligned<ALIGNMENT>(arr);
+    }
+
+
+    // Returns a copy of the allocator
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return alloc;
     }
 
 
     // Destructor
-    ~Vector() = default;
+    ~Vector(){
+        release();
+    }
 };
 
+
+// A Vector whose array starts on an Alignment byte boundary, a cache line by default
+// The capacity is padded to whole multiples of Alignment, so SIMD loops can run over full registers
+template<class T, std::size_t Alignment = 64, class GrowthPolicy = Double_Growth>
+using AlignedVector = Vector<T, Aligned_Allocator<T, Alignment>, GrowthPolicy>;
+
 #endif
\ No newline at end of file
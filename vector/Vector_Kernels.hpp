@@ -0,0 +1,346 @@
+#ifndef VECTOR_KERNELS_HPP
+#define VECTOR_KERNELS_HPP
+
+#include "Vector.hpp"
+#include <bit>
+#include <cstdint>
+
+
+// Search and reduction kernels over arithmetic Vectors
+// Each kernel is written once in a form the compiler vectorizes, then compiled for every instruction set
+// and picked at runtime from what the CPU supports
+
+
+// The instruction sets a kernel can be run with, from slowest to fastest
+// Scalar is never vectorized, SSE2 is the x86-64 baseline (plain portable code on other targets)
+enum class Simd_Level{ Scalar, SSE2, AVX2, AVX512 };
+
+
+// Returns the fastest level the running CPU supports, detected once
+[[nodiscard]] inline Simd_Level simd_level() noexcept {
+    static const Simd_Level level = []{
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl"))
+            return Simd_Level::AVX512;
+        if(__builtin_cpu_supports("avx2")) return Simd_Level::AVX2;
+        if(__builtin_cpu_supports("sse2")) return Simd_Level::SSE2;
+#endif
+        return Simd_Level::Scalar;
+    }();
+    return level;
+}
+
+
+// The type simd_sum() returns for T
+// Integers are summed with 64 bit wrap around, so the result does not depend on the order of the additions
+template<class T>
+using simd_sum_type = std::conditional_t<std::is_floating_point_v<T>, T,
+                      std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>>;
+
+
+namespace simd_detail{
+
+    template<class T>
+    inline constexpr bool is_kernel_type = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+    // Floating point reductions keep this many partial results, one per lane of a 64 byte register
+    // The same number is used at every level, so every level adds and compares in the same order
+    template<class T>
+    inline constexpr std::size_t LANES = sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+
+    // find, count and equal work through blocks of this many elements, about four 64 byte registers
+    template<class T>
+    inline constexpr std::size_t BLOCK = sizeof(T) >= 256 ? 1 : 256 / sizeof(T);
+
+
+    // Number of elements in the block at p equal to value
+    template<class T>
+    [[gnu::always_inline]] inline unsigned block_count(const T* p, const T value) noexcept {
+        unsigned hits = 0;
+        for(std::size_t k = 0; k < BLOCK<T>; ++k) hits += p[k] == value;
+        return hits;
+    }
+
+
+    // Number of positions at which the blocks at a and b differ
+    template<class T>
+    [[gnu::always_inline]] inline unsigned block_mismatches(const T* a, const T* b) noexcept {
+        unsigned misses = 0;
+        for(std::size_t k = 0; k < BLOCK<T>; ++k) misses += a[k] != b[k];
+        return misses;
+    }
+
+
+    template<class T>
+    [[gnu::always_inline]] inline std::size_t find(const T* p, const std::size_t n, const T value) noexcept {
+        std::size_t i = 0;
+        // Skip whole blocks without a match, then pinpoint the match inside its block
+        for(; i + BLOCK<T> <= n && block_count(p + i, value) == 0; i += BLOCK<T>){}
+        for(; i < n; ++i){
+            if(p[i] == value) return i;
+        }
+        return n;
+    }
+
+
+    template<class T>
+    [[gnu::always_inline]] inline std::size_t count(const T* p, const std::size_t n, const T value) noexcept {
+        std::size_t total = 0;
+        std::size_t i = 0;
+        for(; i + BLOCK<T> <= n; i += BLOCK<T>) total += block_count(p + i, value);
+        for(; i < n; ++i) total += p[i] == value;
+        return total;
+    }
+
+
+    template<class T>
+    [[gnu::always_inline]] inline bool equal(const T* a, const T* b, const std::size_t n) noexcept {
+        std::size_t i = 0;
+        for(; i + BLOCK<T> <= n; i += BLOCK<T>){
+            if(block_mismatches(a + i, b + i) != 0) return false;
+        }
+        for(; i < n; ++i){
+            if(a[i] != b[i]) return false;
+        }
+        return true;
+    }
+
+
+    // Lane k combines the elements at indices i with i % LANES == k, then the lanes are folded in halves
+    // Better(x, best) decides if x replaces best
+    template<class T, class Better>
+    [[gnu::always_inline]] inline T select(const T* p, const std::size_t n, Better better) noexcept {
+        constexpr std::size_t L = LANES<T>;
+        T acc[L];
+        for(std::size_t k = 0; k < L; ++k) acc[k] = p[0];
+
+        std::size_t i = 0;
+        for(; i + L <= n; i += L){
+            for(std::size_t k = 0; k < L; ++k) acc[k] = better(p[i + k], acc[k]) ? p[i + k] : acc[k];
+        }
+        for(std::size_t k = 0; i < n; ++i, ++k) acc[k] = better(p[i], acc[k]) ? p[i] : acc[k];
+
+        for(std::size_t w = L / 2; w > 0; w /= 2){
+            for(std::size_t k = 0; k < w; ++k) acc[k] = better(acc[k + w], acc[k]) ? acc[k + w] : acc[k];
+        }
+        return acc[0];
+    }
+
+
+    template<class T>
+    [[gnu::always_inline]] inline simd_sum_type<T> sum(const T* p, const std::size_t n) noexcept {
+        if constexpr(std::is_floating_point_v<T>){
+            // Same lane scheme as select(), so the rounding is identical at every level
+            constexpr std::size_t L = LANES<T>;
+            T acc[L] = {};
+            std::size_t i = 0;
+            for(; i + L <= n; i += L){
+                for(std::size_t k = 0; k < L; ++k) acc[k] += p[i + k];
+            }
+            for(std::size_t k = 0; i < n; ++i, ++k) acc[k] += p[i];
+
+            for(std::size_t w = L / 2; w > 0; w /= 2){
+                for(std::size_t k = 0; k < w; ++k) acc[k] += acc[k + w];
+            }
+            return acc[0];
+        }
+        else{
+            // Unsigned arithmetic wraps instead of overflowing, so any order gives the same bits
+            unsigned long long total = 0;
+            for(std::size_t i = 0; i < n; ++i) total += static_cast<unsigned long long>(p[i]);
+            return static_cast<simd_sum_type<T>>(total);
+        }
+    }
+
+
+    // Number of set bits in x, from shifts, masks and adds only so it vectorizes on every level
+    [[gnu::always_inline]] inline std::uint64_t popcount_word(std::uint64_t x) noexcept {
+        x -= (x >> 1) & 0x5555555555555555ULL;
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        x += x >> 8;
+        x += x >> 16;
+        x += x >> 32;
+        return x & 0x7f;
+    }
+
+
+    [[gnu::always_inline]] inline std::size_t popcount(const std::uint64_t* p, const std::size_t n) noexcept {
+        std::uint64_t total = 0;
+        for(std::size_t i = 0; i < n; ++i) total += popcount_word(p[i]);
+        return static_cast<std::size_t>(total);
+    }
+
+
+#if defined(__x86_64__) || defined(__i386__)
+    // True if the CPU has VPOPCNTQ, which counts the bits of eight words in one instruction
+    [[nodiscard]] inline bool has_vpopcntdq() noexcept {
+        static const bool has = __builtin_cpu_supports("avx512vpopcntdq");
+        return has;
+    }
+
+
+    // popcount() at the AVX-512 level when the CPU has VPOPCNTQ, about 1.7 times the shift and mask version
+    [[gnu::target("avx512f,avx512bw,avx512vl,avx512vpopcntdq,prefer-vector-width=512")]]
+    inline std::size_t popcount_vpopcntdq(const std::uint64_t* p, const std::size_t n) noexcept {
+        std::uint64_t total = 0;
+        for(std::size_t i = 0; i < n; ++i) total += static_cast<std::uint64_t>(std::popcount(p[i]));
+        return static_cast<std::size_t>(total);
+    }
+#endif
+
+
+    // Run f with its kernel inlined and compiled for one level
+#if defined(__x86_64__) || defined(__i386__)
+    template<class F>
+    [[gnu::target("avx512f,avx512bw,avx512vl,prefer-vector-width=512")]] auto run_avx512(const F& f){
+        return f();
+    }
+
+    template<class F>
+    [[gnu::target("avx2")]] auto run_avx2(const F& f){
+        return f();
+    }
+#endif
+
+    template<class F>
+    auto run_sse2(const F& f){
+        return f();
+    }
+
+    template<class F>
+    [[gnu::optimize("no-tree-vectorize")]] auto run_scalar(const F& f){
+        return f();
+    }
+
+
+    // Runs f at level, or at the fastest supported level below it
+    template<class F>
+    auto dispatch(const Simd_Level level, const F& f){
+        switch(std::min(level, simd_level())){
+#if defined(__x86_64__) || defined(__i386__)
+        case Simd_Level::AVX512:
+            return run_avx512(f);
+        case Simd_Level::AVX2:
+            return run_avx2(f);
+#endif
+        case Simd_Level::Scalar:
+            return run_scalar(f);
+        default:
+            return run_sse2(f);
+        }
+    }
+}
+
+
+// Returns the index of the first of the n elements at elts equal to value, or n if there is none
+template<class T>
+[[nodiscard]] std::size_t simd_find(const T* elts, const std::size_t n, const std::type_identity_t<T> value, const Simd_Level level = simd_level()){
+    static_assert(simd_detail::is_kernel_type<T>, "SIMD kernels need an arithmetic element type");
+    return simd_detail::dispatch(level, [=]() __attribute__((always_inline)) { return simd_detail::find(elts, n, value); });
+}
+
+
+// Returns the number of the n elements at elts equal to value
+template<class T>
+[[nodiscard]] std::size_t simd_count(const T* elts, const std::size_t n, const std::type_identity_t<T> value, const Simd_Level level = simd_level()){
+    static_assert(simd_detail::is_kernel_type<T>, "SIMD kernels need an arithmetic element type");
+    return simd_detail::dispatch(level, [=]() __attribute__((always_inline)) { return simd_detail::count(elts, n, value); });
+}
+
+
+// Returns true if the n elements at a and b compare equal pairwise
+template<class T>
+[[nodiscard]] bool simd_equal(const T* a, const T* b, const std::size_t n, const Simd_Level level = simd_level()){
+    static_assert(simd_detail::is_kernel_type<T>, "SIMD kernels need an arithmetic element type");
+    return simd_detail::dispatch(level, [=]() __attribute__((always_inline)) { return simd_detail::equal(a, b, n); });
+}
+
+
+// Returns the smallest of the n elements at elts
+// NaNs are skipped unless elts[0] is one. Throws std::out_of_range when n == 0
+template<class T>
+[[nodiscard]] T simd_min(const T* elts, const std::size_t n, const Simd_Level level = simd_level()){
+    static_assert(simd_detail::is_kernel_type<T>, "SIMD kernels need an arithmetic element type");
+    if(n == 0) throw std::out_of_range("Cannot take the minimum of no elements");
+    return simd_detail::dispatch(level, [=]() __attribute__((always_inline)) {
+        return simd_detail::select(elts, n, [](const T x, const T best){ return x < best; });
+    });
+}
+
+
+// Returns the largest of the n elements at elts
+// NaNs are skipped unless elts[0] is one. Throws std::out_of_range when n == 0
+template<class T>
+[[nodiscard]] T simd_max(const T* elts, const std::size_t n, const Simd_Level level = simd_level()){
+    static_assert(simd_detail::is_kernel_type<T>, "SIMD kernels need an arithmetic element type");
+    if(n == 0) throw std::out_of_range("Cannot take the maximum of no elements");
+    return simd_detail::dispatch(level, [=]() __attribute__((always_inline)) {
+        return simd_detail::select(elts, n, [](const T x, const T best){ return best < x; });
+    });
+}
+
+
+// Returns the sum of the n elements at elts
+// Floating point sums are added in a fixed order, so every level returns the same bits
+template<class T>
+[[nodiscard]] simd_sum_type<T> simd_sum(const T* elts, const std::size_t n, const Simd_Level level = simd_level()){
+    static_assert(simd_detail::is_kernel_type<T>, "SIMD kernels need an arithmetic element type");
+    return simd_detail::dispatch(level, [=]() __attribute__((always_inline)) { return simd_detail::sum(elts, n); });
+}
+
+
+// Returns the number of set bits in the n words at words
+[[nodiscard]] inline std::size_t simd_popcount(const std::uint64_t* words, const std::size_t n, const Simd_Level level = simd_level()){
+#if defined(__x86_64__) || defined(__i386__)
+    if(std::min(level, simd_level()) == Simd_Level::AVX512 && simd_detail::has_vpopcntdq()) return simd_detail::popcount_vpopcntdq(words, n);
+#endif
+    return simd_detail::dispatch(level, [=]() __attribute__((always_inline)) { return simd_detail::popcount(words, n); });
+}
+
+
+// Vector overloads of the kernels above
+
+template<class T, class Allocator, class GrowthPolicy>
+[[nodiscard]] std::size_t simd_find(const Vector<T, Allocator, GrowthPolicy>& vec, const std::type_identity_t<T> value, const Simd_Level level = simd_level()){
+    return simd_find(vec.data(), vec.size(), value, level);
+}
+
+
+template<class T, class Allocator, class GrowthPolicy>
+[[nodiscard]] std::size_t simd_count(const Vector<T, Allocator, GrowthPolicy>& vec, const std::type_identity_t<T> value, const Simd_Level level = simd_level()){
+    return simd_count(vec.data(), vec.size(), value, level);
+}
+
+
+template<class T, class A1, class G1, class A2, class G2>
+[[nodiscard]] bool simd_equal(const Vector<T, A1, G1>& left, const Vector<T, A2, G2>& right, const Simd_Level level = simd_level()){
+    return left.size() == right.size() && simd_equal(left.data(), right.data(), left.size(), level);
+}
+
+
+template<class T, class Allocator, class GrowthPolicy>
+[[nodiscard]] T simd_min(const Vector<T, Allocator, GrowthPolicy>& vec, const Simd_Level level = simd_level()){
+    return simd_min(vec.data(), vec.size(), level);
+}
+
+
+template<class T, class Allocator, class GrowthPolicy>
+[[nodiscard]] T simd_max(const Vector<T, Allocator, GrowthPolicy>& vec, const Simd_Level level = simd_level()){
+    return simd_max(vec.data(), vec.size(), level);
+}
+
+
+template<class T, class Allocator, class GrowthPolicy>
+[[nodiscard]] simd_sum_type<T> simd_sum(const Vector<T, Allocator, GrowthPolicy>& vec, const Simd_Level level = simd_level()){
+    return simd_sum(vec.data(), vec.size(), level);
+}
+
+
+template<class Allocator, class GrowthPolicy>
+[[nodiscard]] std::size_t simd_popcount(const Vector<std::uint64_t, Allocator, GrowthPolicy>& vec, const Simd_Level level = simd_level()){
+    return simd_popcount(vec.data(), vec.size(), level);
+}
+
+#endif
@@ -0,0 +1,693 @@
+// Benchmarks for Vector and the containers built around it
+// Usage: bench.exe [benchmark] [elements]
+// Runs every benchmark when no name is given
+
+#include "Vector.hpp"
+#include "Huge_Vector.hpp"
+#include "Soa_Vector.hpp"
+#include "Vector_Kernels.hpp"
+#include "Parallel.hpp"
+#include "Sort.hpp"
+#include "Concurrent_Vector.hpp"
+#include "Flat_Map.hpp"
+#include "Bit_Vector.hpp"
+#include "Cow_Vector.hpp"
+#include "Persistent_Vector.hpp"
+#include "../bst/Binary_Search_Tree.hpp"
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+// Prevents the optimizer from discarding a computed value
+template<class T>
+void keep(const T& val){
+    asm volatile("" : : "r,m"(val) : "memory");
+}
+
+
+// Returns the wall time taken by f in seconds
+template<class F>
+double time_s(F&& f){
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+
+// Runs f in a child process so its peak RSS is measured in isolation
+// f returns the seconds it spent, which is passed back through a pipe
+template<class F>
+void run_isolated(const char* name, const std::size_t n, F&& f){
+    int fds[2];
+    if(pipe(fds) != 0){
+        std::perror("pipe");
+        return;
+    }
+
+    const pid_t pid = fork();
+    if(pid == 0){
+        close(fds[0]);
+        const double seconds = f();
+        if(write(fds[1], &seconds, sizeof(seconds)) != sizeof(seconds)) std::_Exit(1);
+        std::_Exit(0);
+    }
+    close(fds[1]);
+
+    double seconds = 0;
+    const bool received = read(fds[0], &seconds, sizeof(seconds)) == sizeof(seconds);
+    close(fds[0]);
+
+    int status = 0;
+    rusage usage{};
+    wait4(pid, &status, 0, &usage);
+    if(!received){
+        std::printf("%-28s failed\n", name);
+        return;
+    }
+
+    std::printf("%-28s %10.3f ms %10.1f Melts/s %10ld KiB peak RSS\n", name, seconds * 1e3,
+                static_cast<double>(n) / seconds / 1e6, usage.ru_maxrss);
+}
+
+
+// A 64 byte record, the shape of a typical ingest row
+struct Record{
+    std::size_t fields[8];
+};
+
+
+// push_back throughput and peak memory of each growth policy
+template<class GrowthPolicy>
+double push_back_records(const std::size_t n){
+    Vector<Record, std::allocator<Record>, GrowthPolicy> vec;
+    const double seconds = time_s([&]{
+        for(std::size_t i = 0; i < n; ++i){
+            vec.push_back(Record{{i, i, i, i, i, i, i, i}});
+        }
+    });
+    keep(vec.data());
+    return seconds;
+}
+
+void bench_growth(const std::size_t n){
+    std::printf("== growth policies: push_back of %zu 64 byte records ==\n", n);
+    run_isolated("Double_Growth", n, [n]{ return push_back_records<Double_Growth>(n); });
+    run_isolated("Half_Growth", n, [n]{ return push_back_records<Half_Growth>(n); });
+    run_isolated("Size_Class_Growth", n, [n]{ return push_back_records<Size_Class_Growth>(n); });
+    run_isolated("Fixed_Step_Growth<1M>", n, [n]{ return push_back_records<Fixed_Step_Growth<1 << 20>>(n); });
+}
+
+
+// Growth of a multi-gigabyte array through the copying std::allocator, realloc and mremap
+template<class Vec>
+double push_back_ints(const std::size_t n){
+    Vec vec;
+    const double seconds = time_s([&]{
+        for(std::size_t i = 0; i < n; ++i){
+            vec.push_back(static_cast<std::uint32_t>(i));
+        }
+    });
+    keep(vec.data());
+    return seconds;
+}
+
+void bench_huge(const std::size_t n){
+    std::printf("== huge growth: push_back of %zu uint32_t (pass 1000000000 for 1e9) ==\n", n);
+    run_isolated("Vector (copy on growth)", n, [n]{ return push_back_ints<Vector<std::uint32_t>>(n); });
+    run_isolated("Vector (realloc)", n, [n]{ return push_back_ints<Vector<std::uint32_t, Malloc_Allocator<std::uint32_t>>>(n); });
+    run_isolated("HugeVector (mremap)", n, [n]{ return push_back_ints<HugeVector<std::uint32_t>>(n); });
+}
+
+
+// Scanning one field of an order book stored as rows versus as columns
+struct Order{
+    std::int64_t price;
+    std::int64_t quantity;
+    std::int64_t id;
+    std::int32_t side;
+    std::int32_t flags;
+    double timestamp;
+};
+
+// Repeats a scan and reports the best throughput in GB/s of the field being scanned
+template<class F>
+void report_scan(const char* name, const std::size_t n, F&& scan){
+    double best = 1e30;
+    for(int rep = 0; rep < 5; ++rep){
+        best = std::min(best, time_s(scan));
+    }
+    std::printf("%-28s %10.3f ms %10.2f GB/s of quantities\n", name, best * 1e3,
+                static_cast<double>(n * sizeof(std::int64_t)) / best / 1e9);
+}
+
+void bench_soa(const std::size_t n){
+    std::printf("== structure of arrays: sum of one field over %zu orders ==\n", n);
+
+    Vector<Order> rows;
+    SoaVector<std::int64_t, std::int64_t, std::int64_t, std::int32_t, std::int32_t, double> columns;
+    rows.reserve(n);
+    columns.reserve(n);
+    for(std::size_t i = 0; i < n; ++i){
+        const std::int64_t v = static_cast<std::int64_t>(i);
+        rows.push_back(Order{v, v & 1023, v, 0, 0, 0.0});
+        columns.push_back(v, v & 1023, v, 0, 0, 0.0);
+    }
+
+    report_scan("Vector<Order> field scan", n, [&]{
+        std::int64_t sum = 0;
+        for(std::size_t i = 0; i < rows.size(); ++i){
+            sum += rows[i].quantity;
+        }
+        keep(sum);
+    });
+    report_scan("SoaVector column scan", n, [&]{
+        std::int64_t sum = 0;
+        for(const std::int64_t quantity : columns.column<1>()){
+            sum += quantity;
+        }
+        keep(sum);
+    });
+}
+
+
+// Kernel throughput in GB/s of input, the plain iterator loop against every SIMD level
+template<class F>
+void report_kernel(const char* name, const std::size_t bytes, F&& kernel){
+    double best = 1e30;
+    for(int rep = 0; rep < 5; ++rep){
+        best = std::min(best, time_s(kernel));
+    }
+    std::printf("  %-26s %10.3f ms %10.2f GB/s\n", name, best * 1e3, static_cast<double>(bytes) / best / 1e9);
+}
+
+template<class T>
+void bench_kernels(const char* type, const std::size_t n){
+    Vector<T> vec;
+    vec.reserve(n);
+    for(std::size_t i = 0; i < n; ++i){
+        vec.push_back(static_cast<T>(i % 1000));
+    }
+    const Vector<T> copy(vec);
+    const T missing = static_cast<T>(-1);
+    const std::size_t bytes = n * sizeof(T);
+
+    constexpr Simd_Level levels[] = {Simd_Level::Scalar, Simd_Level::SSE2, Simd_Level::AVX2, Simd_Level::AVX512};
+    constexpr const char* level_names[] = {"Scalar", "SSE2", "AVX2", "AVX512"};
+
+    std::printf("-- find (absent value) over %zu %s --\n", n, type);
+    report_kernel("iterator loop", bytes, [&]{
+        std::size_t idx = 0;
+        for(auto it = vec.cbegin(); it != vec.cend() && *it != missing; ++it, ++idx){}
+        keep(idx);
+    });
+    for(const Simd_Level level : levels){
+        report_kernel(level_names[static_cast<int>(level)], bytes, [&]{ keep(simd_find(vec, missing, level)); });
+    }
+
+    std::printf("-- count over %zu %s --\n", n, type);
+    report_kernel("iterator loop", bytes, [&]{
+        std::size_t total = 0;
+        for(auto it = vec.cbegin(); it != vec.cend(); ++it) total += *it == T(7);
+        keep(total);
+    });
+    for(const Simd_Level level : levels){
+        report_kernel(level_names[static_cast<int>(level)], bytes, [&]{ keep(simd_count(vec, T(7), level)); });
+    }
+
+    std::printf("-- min over %zu %s --\n", n, type);
+    report_kernel("iterator loop", bytes, [&]{
+        T low = vec[0];
+        for(auto it = vec.cbegin(); it != vec.cend(); ++it) low = *it < low ? *it : low;
+        keep(low);
+    });
+    for(const Simd_Level level : levels){
+        report_kernel(level_names[static_cast<int>(level)], bytes, [&]{ keep(simd_min(vec, level)); });
+    }
+
+    std::printf("-- sum over %zu %s --\n", n, type);
+    report_kernel("iterator loop", bytes, [&]{
+        simd_sum_type<T> total = 0;
+        for(auto it = vec.cbegin(); it != vec.cend(); ++it) total += *it;
+        keep(total);
+    });
+    for(const Simd_Level level : levels){
+        report_kernel(level_names[static_cast<int>(level)], bytes, [&]{ keep(simd_sum(vec, level)); });
+    }
+
+    std::printf("-- equal over %zu %s (GB/s of both inputs) --\n", n, type);
+    report_kernel("iterator loop", 2 * bytes, [&]{
+        bool same = true;
+        for(auto a = vec.cbegin(), b = copy.cbegin(); same && a != vec.cend(); ++a, ++b) same = *a == *b;
+        keep(same);
+    });
+    for(const Simd_Level level : levels){
+        report_kernel(level_names[static_cast<int>(level)], 2 * bytes, [&]{ keep(simd_equal(vec, copy, level)); });
+    }
+}
+
+void bench_simd(const std::size_t n){
+    std::printf("== SIMD kernels, this CPU supports up to level %d (0 Scalar, 1 SSE2, 2 AVX2, 3 AVX512) ==\n",
+                static_cast<int>(simd_level()));
+    bench_kernels<std::int32_t>("int32_t", n);
+    bench_kernels<float>("float", n);
+    bench_kernels<double>("double", n);
+}
+
+
+// Each parallel algorithm against the single threaded loop it replaces
+void bench_parallel(const std::size_t n){
+    std::printf("== parallel algorithms over %zu floats, %zu participants in the default pool ==\n", n, default_pool().size());
+    Vector<float> vec;
+    Vector<float> out;
+    vec.resize_for_overwrite(n);
+    out.resize_for_overwrite(n);
+    const std::size_t bytes = n * sizeof(float);
+
+    std::printf("-- fill --\n");
+    report_kernel("serial loop", bytes, [&]{
+        for(std::size_t i = 0; i < n; ++i) vec[i] = 1.5f;
+        keep(vec.data());
+    });
+    report_kernel("parallel_fill", bytes, [&]{
+        parallel_fill(vec, 1.5f);
+        keep(vec.data());
+    });
+
+    std::printf("-- for_each (x = x * 0.5 + 1) --\n");
+    report_kernel("serial loop", bytes, [&]{
+        for(std::size_t i = 0; i < n; ++i) vec[i] = vec[i] * 0.5f + 1.0f;
+        keep(vec.data());
+    });
+    report_kernel("parallel_for_each", bytes, [&]{
+        parallel_for_each(vec, [](float& x){ x = x * 0.5f + 1.0f; });
+        keep(vec.data());
+    });
+
+    std::printf("-- transform (sqrt) --\n");
+    report_kernel("serial loop", bytes, [&]{
+        for(std::size_t i = 0; i < n; ++i) out[i] = std::sqrt(vec[i]);
+        keep(out.data());
+    });
+    report_kernel("parallel_transform", bytes, [&]{
+        parallel_transform(vec, out, [](const float x){ return std::sqrt(x); });
+        keep(out.data());
+    });
+
+    std::printf("-- copy --\n");
+    report_kernel("serial std::copy", bytes, [&]{
+        std::copy(vec.data(), vec.data() + n, out.data());
+        keep(out.data());
+    });
+    report_kernel("parallel_copy", bytes, [&]{
+        parallel_copy(vec, out);
+        keep(out.data());
+    });
+
+    std::printf("-- reduce (sum) --\n");
+    const auto add = [](const double a, const double b){ return a + b; };
+    report_kernel("serial loop", bytes, [&]{
+        double total = 0;
+        for(std::size_t i = 0; i < n; ++i) total += vec[i];
+        keep(total);
+    });
+    report_kernel("parallel_reduce", bytes, [&]{ keep(parallel_reduce(vec, 0.0, add)); });
+    report_kernel("parallel_reduce (commutative)", bytes, [&]{ keep(parallel_reduce(vec, 0.0, add, Parallel_Options{0, true, nullptr})); });
+}
+
+
+// Sorts a fresh copy of data with every sort and reports the best time
+template<class T, class Key>
+void bench_sorts(const char* type, const Vector<T>& data, Key key){
+    const std::size_t n = data.size();
+    const auto less = [&key](const T& a, const T& b){ return key(a) < key(b); };
+    std::printf("-- %zu %s --\n", n, type);
+
+    const auto report = [n](const char* name, auto&& sort, const Vector<T>& source){
+        double best = 1e30;
+        for(int rep = 0; rep < 3; ++rep){
+            Vector<T> vec(source);
+            best = std::min(best, time_s([&]{ sort(vec); }));
+            keep(vec.data());
+        }
+        std::printf("  %-26s %10.3f ms %10.1f Melts/s\n", name, best * 1e3, static_cast<double>(n) / best / 1e6);
+    };
+
+    report("std::sort (IteratorType)", [&](Vector<T>& vec){ std::sort(vec.begin(), vec.end(), less); }, data);
+    report("parallel_sort", [&](Vector<T>& vec){ parallel_sort(vec, less); }, data);
+    report("radix_sort", [&](Vector<T>& vec){ radix_sort(vec, key); }, data);
+}
+
+void bench_sort(const std::size_t n){
+    std::printf("== sorting random keys, %zu participants in the default pool (pass 100000000 for 100M) ==\n", default_pool().size());
+    std::uint64_t state = 88172645463325252ULL;
+    const auto next = [&state]{
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+
+    Vector<std::uint32_t> ints;
+    Vector<double> doubles;
+    Vector<Record> records;
+    ints.reserve(n);
+    doubles.reserve(n);
+    for(std::size_t i = 0; i < n; ++i){
+        ints.push_back(static_cast<std::uint32_t>(next()));
+        doubles.push_back(static_cast<double>(static_cast<std::int64_t>(next())) / 1e9);
+    }
+    bench_sorts("uint32_t", ints, [](const std::uint32_t x){ return x; });
+    ints = Vector<std::uint32_t>();
+    bench_sorts("double", doubles, [](const double x){ return x; });
+    doubles = Vector<double>();
+
+    // Records are only sorted at a tenth of the size to keep the copies in memory
+    records.reserve(n / 10);
+    for(std::size_t i = 0; i < n / 10; ++i){
+        records.push_back(Record{{next(), i, i, i, i, i, i, i}});
+    }
+    bench_sorts("64 byte records by key", records, [](const Record& r){ return r.fields[0]; });
+}
+
+
+// Starts threads producers that each call push(value) per_thread times and returns the seconds until all finish
+template<class Push>
+double run_producers(const std::size_t threads, const std::size_t per_thread, Push&& push){
+    Vector<std::thread> producers;
+    return time_s([&]{
+        for(std::size_t t = 0; t < threads; ++t){
+            producers.emplace_back([&push, t, per_thread]{
+                for(std::size_t i = 0; i < per_thread; ++i) push(t * per_thread + i);
+            });
+        }
+        for(std::size_t t = 0; t < producers.size(); ++t){
+            producers[t].join();
+        }
+    });
+}
+
+void bench_concurrent(const std::size_t n){
+    std::printf("== concurrent push_back of %zu size_t in total, %u hardware threads ==\n", n, std::thread::hardware_concurrency());
+    for(const std::size_t threads : {std::size_t(1), std::size_t(2), std::size_t(4), std::size_t(8)}){
+        const std::size_t per_thread = n / threads;
+        std::printf("-- %zu threads --\n", threads);
+
+        Vector<std::size_t> guarded;
+        std::mutex lock;
+        const double locked = run_producers(threads, per_thread, [&](const std::size_t value){
+            std::lock_guard<std::mutex> guard(lock);
+            guarded.push_back(value);
+        });
+        std::printf("  %-26s %10.3f ms %10.1f Mpush/s\n", "mutex + Vector", locked * 1e3,
+                    static_cast<double>(per_thread * threads) / locked / 1e6);
+
+        ConcurrentVector<std::size_t> concurrent;
+        const double lock_free = run_producers(threads, per_thread, [&](const std::size_t value){
+            concurrent.push_back(value);
+        });
+        std::printf("  %-26s %10.3f ms %10.1f Mpush/s\n", "ConcurrentVector", lock_free * 1e3,
+                    static_cast<double>(per_thread * threads) / lock_free / 1e6);
+        keep(guarded.data());
+        keep(concurrent.size());
+    }
+}
+
+
+// Times lookups of every query with contains and reports the best of three in ns per lookup
+template<class Contains>
+void report_lookups(const char* name, const Vector<std::uint64_t>& queries, Contains&& contains){
+    double best = 1e30;
+    std::size_t hits = 0;
+    for(int rep = 0; rep < 3; ++rep){
+        hits = 0;
+        best = std::min(best, time_s([&]{
+            for(std::size_t i = 0; i < queries.size(); ++i) hits += contains(queries[i]);
+        }));
+    }
+    keep(hits);
+    std::printf("  %-26s %10.3f ms %10.2f ns/lookup\n", name, best * 1e3, best * 1e9 / static_cast<double>(queries.size()));
+}
+
+void bench_flat(const std::size_t n){
+    constexpr std::size_t QUERIES = 1000000;
+    std::printf("== %zu random lookups, half hits, from 1000 keys up to %zu (pass 10000000 for 10M) ==\n", QUERIES, n);
+    std::uint64_t state = 88172645463325252ULL;
+    const auto next = [&state]{
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+
+    for(std::size_t size = 1000; size <= n; size *= 10){
+        std::printf("-- %zu keys --\n", size);
+
+        // Even keys are stored, so a random query below 2 * size hits half the time
+        Vector<std::uint64_t> keys;
+        keys.reserve(size);
+        for(std::size_t i = 0; i < size; ++i) keys.push_back(2 * i);
+        for(std::size_t i = size - 1; i > 0; --i) std::swap(keys[i], keys[next() % (i + 1)]);
+        Vector<std::uint64_t> queries;
+        queries.reserve(QUERIES);
+        for(std::size_t i = 0; i < QUERIES; ++i) queries.push_back(next() % (2 * size));
+
+        // The tree is built from shuffled keys so it stays roughly balanced
+        BST<std::uint64_t> tree;
+        for(std::size_t i = 0; i < size; ++i) tree.insert(keys[i]);
+        report_lookups("BST::search", queries, [&tree](const std::uint64_t key){ return tree.search(key); });
+
+        Vector<std::uint64_t> sorted(keys);
+        std::sort(sorted.data(), sorted.data() + sorted.size());
+        report_lookups("std::binary_search", queries, [&sorted](const std::uint64_t key){
+            return std::binary_search(sorted.data(), sorted.data() + sorted.size(), key);
+        });
+
+        const FlatSet<std::uint64_t> set(keys.cbegin(), keys.cend());
+        report_lookups("FlatSet::contains", queries, [&set](const std::uint64_t key){ return set.contains(key); });
+
+        Vector<std::pair<std::uint64_t, std::uint64_t>> pairs;
+        pairs.reserve(size);
+        for(std::size_t i = 0; i < size; ++i) pairs.emplace_back(keys[i], i);
+        const FlatMap<std::uint64_t, std::uint64_t> map(pairs.cbegin(), pairs.cend());
+        report_lookups("FlatMap::find", queries, [&map](const std::uint64_t key){ return map.find(key) != map.size(); });
+    }
+}
+
+
+void bench_bits(const std::size_t n){
+    std::printf("== %zu bits, a quarter set at random (pass 4000000000 for 4G) ==\n", n);
+    std::uint64_t state = 88172645463325252ULL;
+    const auto next = [&state]{
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+
+    BitVector a;
+    BitVector b;
+    Vector<bool> flags;
+    a.reserve(n);
+    b.reserve(n);
+    flags.reserve(n);
+    for(std::size_t i = 0; i < n; ++i){
+        const std::uint64_t r = next();
+        a.push_back((r & 3) == 0);
+        b.push_back((r & 12) == 0);
+        flags.push_back((r & 3) == 0);
+    }
+    std::printf("  BitVector %zu MB, Vector<bool> %zu MB\n", a.words().size() * 8 >> 20, flags.size() >> 20);
+
+    std::printf("-- count --\n");
+    report_kernel("Vector<bool> std::count", flags.size(), [&]{ keep(std::count(flags.begin(), flags.end(), true)); });
+    report_kernel("BitVector popcount Scalar", n / 8, [&]{ keep(simd_popcount(a.words(), Simd_Level::Scalar)); });
+    report_kernel("BitVector popcount AVX2", n / 8, [&]{ keep(simd_popcount(a.words(), Simd_Level::AVX2)); });
+    report_kernel("BitVector popcount", n / 8, [&]{ keep(a.count()); });
+
+    std::printf("-- and --\n");
+    Vector<bool> other(flags);
+    report_kernel("Vector<bool> loop", flags.size(), [&]{
+        for(std::size_t i = 0; i < flags.size(); ++i) flags[i] = flags[i] && other[i];
+        keep(flags.data());
+    });
+    report_kernel("BitVector &=", n / 8, [&]{ a &= b; keep(a.data()); });
+
+    // Queries at random positions, so most of them miss the cache
+    constexpr std::size_t QUERIES = 1000000;
+    const std::size_t ones = a.count();
+    Vector<std::size_t> positions;
+    Vector<std::size_t> ranks;
+    for(std::size_t i = 0; i < QUERIES; ++i){
+        positions.push_back(next() % (n + 1));
+        ranks.push_back(next() % ones);
+    }
+    std::printf("-- %zu random queries, index built in %.3f ms --\n", QUERIES, time_s([&]{ a.build_index(); }) * 1e3);
+    const double rank = time_s([&]{
+        std::size_t total = 0;
+        for(std::size_t i = 0; i < QUERIES; ++i) total += a.rank(positions[i]);
+        keep(total);
+    });
+    std::printf("  %-26s %10.3f ms %10.2f ns/query\n", "rank", rank * 1e3, rank * 1e9 / QUERIES);
+    const double select = time_s([&]{
+        std::size_t total = 0;
+        for(std::size_t i = 0; i < QUERIES; ++i) total += a.select(ranks[i]);
+        keep(total);
+    });
+    std::printf("  %-26s %10.3f ms %10.2f ns/query\n", "select", select * 1e3, select * 1e9 / QUERIES);
+}
+
+
+// Hands out snapshots of a large array to readers while the owner makes an occasional change
+void bench_cow(const std::size_t n){
+    constexpr std::size_t SNAPSHOTS = 100;
+    std::printf("== %zu snapshots of %zu size_t, the owner writes once every 10 snapshots ==\n", SNAPSHOTS, n);
+
+    const auto run = [n](const char* name, auto config){
+        std::size_t total = 0;
+        const double seconds = time_s([&]{
+            for(std::size_t s = 0; s < SNAPSHOTS; ++s){
+                const auto snapshot = config;
+                total += snapshot[s % n];
+                if(s % 10 == 9) config[s % n] = s;
+            }
+        });
+        keep(total);
+        std::printf("  %-26s %10.3f ms %10.2f us/snapshot\n", name, seconds * 1e3, seconds * 1e6 / SNAPSHOTS);
+    };
+
+    Vector<std::size_t> vec(n, 1);
+    run("Vector copy", vec);
+    run("CowVector share", CowVector<std::size_t>(std::move(vec)));
+}
+
+
+// Keeps versions+1 versions of an n element array, each changing one element of the previous one
+template<class Version, class Set>
+double keep_versions(const std::size_t n, const std::size_t versions, const Version& first, Set&& set){
+    Vector<Version> history;
+    history.reserve(versions + 1);
+    history.push_back(first);
+    std::uint64_t state = 88172645463325252ULL;
+    const double seconds = time_s([&]{
+        for(std::size_t v = 0; v < versions; ++v){
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            history.push_back(set(history.back(), state % n, v));
+        }
+    });
+    keep(history.data());
+    return seconds;
+}
+
+void bench_persistent(const std::size_t n){
+    constexpr std::size_t VERSIONS = 100;
+    std::printf("== persistent vectors of %zu size_t ==\n", n);
+    std::printf("-- building with push_back --\n");
+    run_isolated("Vector", n, [n]{
+        Vector<std::size_t> vec;
+        const double seconds = time_s([&]{ for(std::size_t i = 0; i < n; ++i) vec.push_back(i); });
+        keep(vec.data());
+        return seconds;
+    });
+    run_isolated("PersistentVector", n, [n]{
+        PersistentVector<std::size_t> vec;
+        const double seconds = time_s([&]{ for(std::size_t i = 0; i < n; ++i) vec = vec.push_back(i); });
+        keep(vec.size());
+        return seconds;
+    });
+    run_isolated("TransientVector", n, [n]{
+        TransientVector<std::size_t> builder;
+        const double seconds = time_s([&]{ for(std::size_t i = 0; i < n; ++i) builder.push_back(i); });
+        keep(builder.size());
+        return seconds;
+    });
+
+    std::printf("-- keeping %zu versions that each change one element (Melts/s counts the elements of every new version) --\n", VERSIONS + 1);
+    run_isolated("Vector copy per version", VERSIONS * n, [n]{
+        Vector<std::size_t> first;
+        for(std::size_t i = 0; i < n; ++i) first.push_back(i);
+        return keep_versions(n, VERSIONS, first, [](const Vector<std::size_t>& prev, const std::size_t i, const std::size_t value){
+            Vector<std::size_t> next(prev);
+            next[i] = value;
+            return next;
+        });
+    });
+    run_isolated("PersistentVector::set", VERSIONS * n, [n]{
+        TransientVector<std::size_t> builder;
+        for(std::size_t i = 0; i < n; ++i) builder.push_back(i);
+        return keep_versions(n, VERSIONS, builder.persistent(), [](const PersistentVector<std::size_t>& prev, const std::size_t i, const std::size_t value){
+            return prev.set(i, value);
+        });
+    });
+
+    std::printf("-- reading every element in order --\n");
+    Vector<std::size_t> vec;
+    TransientVector<std::size_t> builder;
+    for(std::size_t i = 0; i < n; ++i){
+        vec.push_back(i);
+        builder.push_back(i);
+    }
+    const PersistentVector<std::size_t> persistent = builder.persistent();
+    report_kernel("Vector[]", n * sizeof(std::size_t), [&]{
+        std::size_t total = 0;
+        for(std::size_t i = 0; i < n; ++i) total += vec[i];
+        keep(total);
+    });
+    report_kernel("PersistentVector[]", n * sizeof(std::size_t), [&]{
+        std::size_t total = 0;
+        for(std::size_t i = 0; i < n; ++i) total += persistent[i];
+        keep(total);
+    });
+}
+
+
+struct Benchmark{
+    const char* name;
+    void (*run)(std::size_t);
+    std::size_t default_elements;
+};
+
+constexpr Benchmark benchmarks[] = {
+    {"growth", bench_growth, 10000000},
+    {"huge", bench_huge, 100000000},
+    {"soa", bench_soa, 10000000},
+    {"simd", bench_simd, 1000000},
+    {"parallel", bench_parallel, 100000000},
+    {"sort", bench_sort, 10000000},
+    {"concurrent", bench_concurrent, 10000000},
+    {"flat", bench_flat, 1000000},
+    {"bits", bench_bits, 1000000000},
+    {"cow", bench_cow, 10000000},
+    {"persistent", bench_persistent, 1000000},
+};
+
+
+int main(int argc, char** argv){
+    const char* only = argc > 1 ? argv[1] : nullptr;
+    const std::size_t elements = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+
+    bool found = false;
+    for(const Benchmark& b : benchmarks){
+        if(only != nullptr && std::strcmp(only, b.name) != 0) continue;
+        found = true;
+        b.run(elements > 0 ? elements : b.default_elements);
+    }
+
+    if(!found){
+        std::fprintf(stderr, "Unknown benchmark %s\n", only);
+        return 1;
+    }
+    return 0;
+}
@@ -1,6 +1,30 @@
 #define BOOST_TEST_MODULE vector
 #include <boost/test/included/unit_test.hpp>
 #include "Vector.hpp"
+#include "Small_Vector.hpp"
+#include "Inplace_Vector.hpp"
+#include "Huge_Vector.hpp"
+#include "Mapped_Vector.hpp"
+#include "Soa_Vector.hpp"
+#include "Vector_Kernels.hpp"
+#include "Parallel.hpp"
+#include "Sort.hpp"
+#include "Concurrent_Vector.hpp"
+#include "Stable_Vector.hpp"
+#include "Flat_Map.hpp"
+#include "Bit_Vector.hpp"
+#include "Cow_Vector.hpp"
+#include "Persistent_Vector.hpp"
+#include <string>
+#include <list>
+#include <set>
+#include <sstream>
+#include <iterator>
+#include <cstdint>
+#include <cmath>
+#include <random>
+#include <limits>
+#include <thread>
 
 
 BOOST_AUTO_TEST_CASE(add_ints){
@@ -445,8 +469,9 @@ BOOST_AUTO_TEST_CASE(resize){
 
     vec.resize(5);
 
+    // Shrinking keeps the capacity
     BOOST_TEST(vec.size() == 5);
-    BOOST_TEST(vec.capacity() == 5);
+    BOOST_TEST(vec.capacity() == 20);
 
     for(std::size_t i = 0; i < 5; ++i){
         BOOST_TEST(vec[i] == i);
@@ -514,4 +539,1704 @@ BOOST_AUTO_TEST_CASE(random_access_iterator){
     for(std::size_t i = 0; i < vec.size(); ++i){
         BOOST_TEST(vec[i] == i);
     }
-}
\ No newline at end of file
+}
+
+// A type that cannot be default constructed and counts its live instances
+struct Counted{
+    static int live;
+    int val;
+
+    explicit Counted(const int _val) :
+    val{_val} { ++live; }
+
+    Counted(const Counted& other) :
+    val{other.val} { ++live; }
+
+    Counted(Counted&& other) noexcept :
+    val{other.val} { ++live; }
+
+    ~Counted(){ --live; }
+};
+int Counted::live = 0;
+
+
+BOOST_AUTO_TEST_CASE(no_default_construction){
+    {
+        Vector<Counted> vec;
+        for(int i = 0; i < 10; ++i){
+            vec.emplace_back(i);
+        }
+
+        // Growth must only construct the elements that are actually stored
+        BOOST_TEST(vec.size() == 10);
+        BOOST_TEST(vec.capacity() == 16);
+        BOOST_TEST(Counted::live == 10);
+
+        vec.reserve(100);
+        BOOST_TEST(Counted::live == 10);
+
+        vec.pop_back();
+        BOOST_TEST(Counted::live == 9);
+
+        Vector<Counted> vec_copy(vec);
+        BOOST_TEST(Counted::live == 18);
+
+        vec.shrink_to_fit();
+        BOOST_TEST(vec.capacity() == 9);
+        BOOST_TEST(Counted::live == 18);
+
+        for(int i = 0; i < 9; ++i){
+            BOOST_TEST(vec[static_cast<std::size_t>(i)].val == i);
+            BOOST_TEST(vec_copy[static_cast<std::size_t>(i)].val == i);
+        }
+
+        vec.clear();
+        BOOST_TEST(Counted::live == 9);
+    }
+
+    // Every element is destroyed with the vectors
+    BOOST_TEST(Counted::live == 0);
+}
+
+
+// A type whose default construction and copies throw once countdown reaches zero, counting its live instances
+struct Throwing_Copy{
+    static int live;
+    static int countdown;
+    int val;
+
+    static void tick(){
+        if(countdown >= 0 && countdown-- == 0) throw std::runtime_error("Throwing_Copy");
+    }
+
+    Throwing_Copy() :
+    val{0} { tick(); ++live; }
+
+    explicit Throwing_Copy(const int _val) :
+    val{_val} { ++live; }
+
+    Throwing_Copy(const Throwing_Copy& other) :
+    val{other.val} { tick(); ++live; }
+
+    Throwing_Copy& operator=(const Throwing_Copy&) = default;
+
+    ~Throwing_Copy(){ --live; }
+};
+int Throwing_Copy::live = 0;
+int Throwing_Copy::countdown = -1;
+
+
+// An allocator counting the arrays it has handed out and not yet taken back
+template<class T>
+struct Counting_Allocator{
+    typedef T value_type;
+    static inline int outstanding = 0;
+
+    Counting_Allocator() noexcept = default;
+
+    template<class U>
+    Counting_Allocator(const Counting_Allocator<U>&) noexcept {}
+
+    T* allocate(const std::size_t n){
+        ++outstanding;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, const std::size_t n) noexcept {
+        --outstanding;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    friend bool operator==(const Counting_Allocator&, const Counting_Allocator&) noexcept { return true; }
+    friend bool operator!=(const Counting_Allocator&, const Counting_Allocator&) noexcept { return false; }
+};
+
+
+BOOST_AUTO_TEST_CASE(constructor_exception_safety){
+    typedef Vector<Throwing_Copy, Counting_Allocator<Throwing_Copy>> Vec;
+    const Throwing_Copy elt(7);
+    {
+        Vec source;
+        for(int i = 0; i < 10; ++i) source.emplace_back(i);
+        BOOST_TEST(Throwing_Copy::live == 11);
+        BOOST_TEST(Counting_Allocator<Throwing_Copy>::outstanding == 1);
+
+        // The fifth copy throws, the four copies built are destroyed and the array is freed
+        Throwing_Copy::countdown = 4;
+        BOOST_CHECK_THROW(Vec copy(source), std::runtime_error);
+        BOOST_TEST(Throwing_Copy::live == 11);
+        BOOST_TEST(Counting_Allocator<Throwing_Copy>::outstanding == 1);
+
+        Throwing_Copy::countdown = 4;
+        BOOST_CHECK_THROW(Vec filled(10, elt), std::runtime_error);
+        BOOST_TEST(Throwing_Copy::live == 11);
+        BOOST_TEST(Counting_Allocator<Throwing_Copy>::outstanding == 1);
+
+        Throwing_Copy::countdown = 4;
+        BOOST_CHECK_THROW(Vec sized(10), std::runtime_error);
+        BOOST_TEST(Throwing_Copy::live == 11);
+        BOOST_TEST(Counting_Allocator<Throwing_Copy>::outstanding == 1);
+
+        Throwing_Copy::countdown = 1;
+        BOOST_CHECK_THROW(Vec listed({elt, elt, elt}), std::runtime_error);
+        BOOST_TEST(Throwing_Copy::live == 11);
+        BOOST_TEST(Counting_Allocator<Throwing_Copy>::outstanding == 1);
+
+        // Without a throw the copy is complete
+        Throwing_Copy::countdown = -1;
+        Vec copy(source);
+        BOOST_TEST(copy.size() == 10);
+        BOOST_TEST(copy[9].val == 9);
+        BOOST_TEST(Throwing_Copy::live == 21);
+    }
+    BOOST_TEST(Throwing_Copy::live == 1);
+    BOOST_TEST(Counting_Allocator<Throwing_Copy>::outstanding == 0);
+}
+
+
+// Owns a heap allocation, so it is not trivially copyable but can be relocated with memcpy
+struct Boxed{
+    int* val;
+
+    explicit Boxed(const int _val) :
+    val{new int(_val)} {}
+
+    Boxed(Boxed&& other) noexcept :
+    val{other.val} { other.val = nullptr; }
+
+    Boxed(const Boxed&) = delete;
+    Boxed& operator=(const Boxed&) = delete;
+
+    ~Boxed(){ delete val; }
+};
+
+template<>
+struct is_trivially_relocatable<Boxed> : std::true_type {};
+
+
+BOOST_AUTO_TEST_CASE(malloc_allocator_relocation){
+    // Trivially copyable elements grow through realloc
+    Vector<std::size_t, Malloc_Allocator<std::size_t>> vec;
+    for(std::size_t i = 0; i < 100; ++i){
+        vec.push_back(i);
+    }
+
+    BOOST_TEST(vec.size() == 100);
+    BOOST_TEST(vec.capacity() == 128);
+
+    vec.shrink_to_fit();
+    BOOST_TEST(vec.capacity() == 100);
+
+    vec.resize(50);
+    vec.shrink_to_fit();
+    BOOST_TEST(vec.size() == 50);
+    BOOST_TEST(vec.capacity() == 50);
+
+    // Copies of trivially copyable elements are a single memcpy
+    Vector<std::size_t, Malloc_Allocator<std::size_t>> vec_copy(vec);
+    for(std::size_t i = 0; i < 50; ++i){
+        BOOST_TEST(vec[i] == i);
+        BOOST_TEST(vec_copy[i] == i);
+    }
+
+    // Opted in relocatable elements keep ownership of their resources when moved by realloc
+    Vector<Boxed, Malloc_Allocator<Boxed>> boxes;
+    for(int i = 0; i < 20; ++i){
+        boxes.emplace_back(i);
+    }
+    boxes.reserve(1000);
+    for(int i = 0; i < 10; ++i){
+        boxes.pop_back();
+    }
+    boxes.shrink_to_fit();
+
+    BOOST_TEST(boxes.size() == 10);
+    for(int i = 0; i < 10; ++i){
+        BOOST_TEST(*boxes[static_cast<std::size_t>(i)].val == i);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(growth_policies){
+    // Half growth follows 2, 3, 4, 6, 9, 13, 19, ...
+    Vector<std::size_t, std::allocator<std::size_t>, Half_Growth> half;
+    for(std::size_t i = 0; i < 10; ++i){
+        half.push_back(i);
+    }
+    BOOST_TEST(half.size() == 10);
+    BOOST_TEST(half.capacity() == 13);
+
+    // Size classes fill the whole malloc chunk (3 * 8 bytes fits the 24 byte usable size of a 32 byte chunk)
+    Vector<std::size_t, std::allocator<std::size_t>, Size_Class_Growth> sized;
+    sized.push_back(0);
+    BOOST_TEST(sized.capacity() == 3);
+    for(std::size_t i = 1; i < 1000; ++i){
+        sized.push_back(i);
+    }
+    BOOST_TEST((Size_Class_Growth::usable_size(sized.capacity() * sizeof(std::size_t)) / sizeof(std::size_t)) == sized.capacity());
+
+    // Fixed steps double up to the step, then grow linearly
+    Vector<std::size_t, std::allocator<std::size_t>, Fixed_Step_Growth<64>> stepped;
+    for(std::size_t i = 0; i < 200; ++i){
+        stepped.push_back(i);
+    }
+    BOOST_TEST(stepped.capacity() == 256);
+    stepped.push_back(200);
+    for(std::size_t i = 0; i < 200; ++i){
+        BOOST_TEST(stepped[i] == i);
+    }
+
+    // Every policy must satisfy the required size
+    BOOST_TEST(Double_Growth::next<int>(4, 100) == 100);
+    BOOST_TEST(Half_Growth::next<int>(4, 100) == 100);
+    BOOST_TEST(Fixed_Step_Growth<8>::next<int>(64, 100) == 100);
+}
+
+
+BOOST_AUTO_TEST_CASE(small_vector_inline_and_spill){
+    SmallVector<std::size_t, 8> vec;
+
+    // The first eight elements stay inside the object
+    for(std::size_t i = 0; i < 8; ++i){
+        vec.push_back(i);
+    }
+    BOOST_TEST(vec.size() == 8);
+    BOOST_TEST(vec.capacity() == 8);
+    BOOST_TEST(vec.is_inline());
+    BOOST_TEST(static_cast<void*>(vec.data()) >= static_cast<void*>(&vec));
+    BOOST_TEST(static_cast<void*>(vec.data()) < static_cast<void*>(&vec + 1));
+
+    // The ninth spills to the heap
+    vec.push_back(8);
+    BOOST_TEST(!vec.is_inline());
+    BOOST_TEST(vec.capacity() == 16);
+
+    std::size_t idx = 0;
+    for(const std::size_t i : vec){
+        BOOST_TEST(i == idx++);
+    }
+
+    // Shrinking below N moves the elements back inline
+    vec.resize(4);
+    BOOST_TEST(!vec.is_inline());
+    vec.shrink_to_fit();
+    BOOST_TEST(vec.is_inline());
+    BOOST_TEST(vec.capacity() == 8);
+    for(std::size_t i = 0; i < 4; ++i){
+        BOOST_TEST(vec[i] == i);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(small_vector_copy_move){
+    {
+        SmallVector<Counted, 4> small;
+        SmallVector<Counted, 4> large;
+        for(int i = 0; i < 3; ++i){
+            small.emplace_back(i);
+        }
+        for(int i = 0; i < 10; ++i){
+            large.emplace_back(i);
+        }
+        BOOST_TEST(Counted::live == 13);
+
+        // Copies only spill when the source does not fit inline
+        SmallVector<Counted, 4> small_copy(small);
+        SmallVector<Counted, 4> large_copy(large);
+        BOOST_TEST(small_copy.is_inline());
+        BOOST_TEST(!large_copy.is_inline());
+        BOOST_TEST(Counted::live == 26);
+
+        // Moving a heap vector steals its array
+        const Counted* p = large.data();
+        SmallVector<Counted, 4> large_move(std::move(large));
+        BOOST_TEST(large_move.data() == p);
+        BOOST_TEST(large.empty());
+        BOOST_TEST(large.is_inline());
+
+        // Moving an inline vector moves each element
+        SmallVector<Counted, 4> small_move;
+        small_move = std::move(small);
+        BOOST_TEST(small_move.is_inline());
+        BOOST_TEST(small_move.size() == 3);
+        BOOST_TEST(Counted::live == 26);
+
+        for(std::size_t i = 0; i < 3; ++i){
+            BOOST_TEST(small_move[i].val == static_cast<int>(i));
+            BOOST_TEST(small_copy[i].val == static_cast<int>(i));
+        }
+        for(std::size_t i = 0; i < 10; ++i){
+            BOOST_TEST(large_move[i].val == static_cast<int>(i));
+            BOOST_TEST(large_copy[i].val == static_cast<int>(i));
+        }
+
+        large_copy = small_copy;
+        BOOST_TEST(large_copy.is_inline());
+        BOOST_TEST(Counted::live == 19);
+    }
+
+    BOOST_TEST(Counted::live == 0);
+}
+
+
+// Builds and sums an InplaceVector, usable in a constant expression
+constexpr int inplace_sum(){
+    InplaceVector<int, 8> vec;
+    for(int i = 0; i < 10; ++i){
+        if(vec.try_push_back(i) == nullptr) break;
+    }
+    vec.pop_back();
+
+    InplaceVector<int, 8> copy(vec);
+    int sum = 0;
+    for(const int i : copy){
+        sum += i;
+    }
+    return sum + static_cast<int>(copy.size());
+}
+
+
+BOOST_AUTO_TEST_CASE(inplace_vector){
+    // Evaluated entirely at compile time
+    static_assert(inplace_sum() == 21 + 7);
+
+    InplaceVector<Counted, 4> vec;
+    BOOST_TEST(vec.capacity() == 4);
+
+    for(int i = 0; i < 4; ++i){
+        BOOST_TEST(vec.try_emplace_back(i) != nullptr);
+    }
+    BOOST_TEST(vec.full());
+    BOOST_TEST(Counted::live == 4);
+
+    // A full vector refuses more elements without constructing them
+    BOOST_TEST(vec.try_emplace_back(4) == nullptr);
+    BOOST_CHECK_THROW(vec.emplace_back(4), std::out_of_range);
+    BOOST_TEST(Counted::live == 4);
+
+    // Storage lives inside the object
+    BOOST_TEST(static_cast<void*>(vec.data()) >= static_cast<void*>(&vec));
+    BOOST_TEST(static_cast<void*>(vec.data()) < static_cast<void*>(&vec + 1));
+
+    InplaceVector<Counted, 4> moved(std::move(vec));
+    vec.clear();
+    BOOST_TEST(Counted::live == 4);
+    for(std::size_t i = 0; i < 4; ++i){
+        BOOST_TEST(moved[i].val == static_cast<int>(i));
+    }
+
+    moved.pop_back();
+    moved.pop_back();
+    BOOST_TEST(Counted::live == 2);
+
+    InplaceVector<std::size_t, 16> sized(10);
+    BOOST_TEST(sized.size() == 10);
+    BOOST_CHECK_THROW(sized.resize(17), std::out_of_range);
+}
+
+
+BOOST_AUTO_TEST_CASE(inplace_vector_exception_safety){
+    typedef InplaceVector<Throwing_Copy, 10> Vec;
+    const Throwing_Copy elt(7);
+    {
+        Vec source;
+        for(int i = 0; i < 10; ++i) source.emplace_back(i);
+        BOOST_TEST(Throwing_Copy::live == 11);
+
+        // The fifth element throws, the four built before it are destroyed
+        Throwing_Copy::countdown = 4;
+        BOOST_CHECK_THROW(Vec sized(10), std::runtime_error);
+        BOOST_TEST(Throwing_Copy::live == 11);
+
+        Throwing_Copy::countdown = 4;
+        BOOST_CHECK_THROW(Vec filled(10, elt), std::runtime_error);
+        BOOST_TEST(Throwing_Copy::live == 11);
+
+        Throwing_Copy::countdown = 4;
+        BOOST_CHECK_THROW(Vec copy(source), std::runtime_error);
+        BOOST_TEST(Throwing_Copy::live == 11);
+
+        // Throwing_Copy has no move constructor, so moving copies too
+        Throwing_Copy::countdown = 4;
+        BOOST_CHECK_THROW(Vec moved(std::move(source)), std::runtime_error);
+        BOOST_TEST(Throwing_Copy::live == 11);
+        Throwing_Copy::countdown = -1;
+    }
+    BOOST_TEST(Throwing_Copy::live == 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(bulk_insert_erase_trivial){
+    // Initializer lists reserve exactly once
+    Vector<int> vec{0, 1, 2, 3, 4};
+    BOOST_TEST(vec.size() == 5);
+    BOOST_TEST(vec.capacity() == 5);
+
+    // Appending a range grows once, through the growth policy
+    const int more[] = {5, 6, 7, 8, 9, 10};
+    vec.append(std::begin(more), std::end(more));
+    BOOST_TEST(vec.size() == 11);
+    BOOST_TEST(vec.capacity() == 11);
+    for(std::size_t i = 0; i < vec.size(); ++i){
+        BOOST_TEST(vec[i] == static_cast<int>(i));
+    }
+
+    // Middle inserts shift the tail
+    vec.insert(2, {-1, -2});
+    vec.insert(0, 3, 7);
+    vec.insert(vec.size(), 42);
+    const int expected[] = {7, 7, 7, 0, 1, -1, -2, 2, 3, 4, 5, 6, 7, 8, 9, 10, 42};
+    BOOST_TEST(vec.size() == std::size(expected));
+    for(std::size_t i = 0; i < vec.size(); ++i){
+        BOOST_TEST(vec[i] == expected[i]);
+    }
+
+    // Inserting an element of the vector itself is safe even when the array moves
+    vec.shrink_to_fit();
+    vec.insert(1, 2, vec.back());
+    BOOST_TEST(vec[1] == 42);
+    BOOST_TEST(vec[2] == 42);
+
+    // Erase single elements and ranges
+    vec.erase(0, 6);
+    vec.erase(0);
+    BOOST_TEST(vec.front() == -1);
+    BOOST_TEST(vec.size() == 12);
+    BOOST_CHECK_THROW(vec.erase(3, 100), std::out_of_range);
+    BOOST_CHECK_THROW(vec.insert(100, 0), std::out_of_range);
+
+    // Assign replaces everything
+    Vector<int> other(3, 9);
+    vec.assign(other.begin(), other.end());
+    BOOST_TEST(vec.size() == 3);
+    BOOST_TEST(vec[2] == 9);
+    vec.assign(5, 1);
+    BOOST_TEST(vec.size() == 5);
+    vec = {4, 5};
+    BOOST_TEST(vec.size() == 2);
+    BOOST_TEST(vec[1] == 5);
+}
+
+
+BOOST_AUTO_TEST_CASE(bulk_insert_erase_nontrivial){
+    Vector<std::string> vec{"a", "b", "c"};
+
+    // Forward, non-contiguous ranges
+    const std::list<std::string> letters{"x", "y"};
+    vec.insert(1, letters.begin(), letters.end());
+
+    // Single pass ranges
+    std::istringstream words("p q");
+    vec.insert(0, std::istream_iterator<std::string>(words), std::istream_iterator<std::string>());
+    vec.emplace(vec.size(), 2, 'z');
+    vec.append({"d"});
+
+    const char* expected[] = {"p", "q", "a", "x", "y", "b", "c", "zz", "d"};
+    BOOST_TEST(vec.size() == std::size(expected));
+    for(std::size_t i = 0; i < vec.size(); ++i){
+        BOOST_TEST(vec[i] == expected[i]);
+    }
+
+    vec.erase(1, 4);
+    vec.erase(vec.size() - 1);
+    const char* remaining[] = {"p", "y", "b", "c", "zz"};
+    BOOST_TEST(vec.size() == std::size(remaining));
+    for(std::size_t i = 0; i < vec.size(); ++i){
+        BOOST_TEST(vec[i] == remaining[i]);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(resize_for_overwrite){
+    Vector<char> vec;
+    vec.reserve(64);
+    char* p = vec.data();
+
+    // Growing within capacity keeps the array
+    vec.resize_for_overwrite(48);
+    BOOST_TEST(vec.size() == 48);
+    BOOST_TEST(vec.capacity() == 64);
+    BOOST_TEST(static_cast<void*>(vec.data()) == static_cast<void*>(p));
+    std::memset(vec.data(), 'a', vec.size());
+
+    // Shrinking keeps the array too
+    vec.resize_for_overwrite(16);
+    BOOST_TEST(vec.size() == 16);
+    BOOST_TEST(static_cast<void*>(vec.data()) == static_cast<void*>(p));
+
+    // Raw slots can be filled directly, like a read() into the vector
+    std::span<char> slots = vec.append_uninitialized(8);
+    BOOST_TEST(slots.size() == 8);
+    BOOST_TEST(static_cast<void*>(slots.data()) == static_cast<void*>(p + 16));
+    std::memcpy(slots.data(), "01234567", 8);
+    BOOST_TEST(vec.size() == 24);
+    BOOST_TEST(vec[16] == '0');
+    BOOST_TEST(vec[23] == '7');
+    BOOST_TEST(vec[15] == 'a');
+
+    // Past capacity, appends grow through the growth policy
+    slots = vec.append_uninitialized(100);
+    BOOST_TEST(vec.size() == 124);
+    BOOST_TEST(vec.capacity() == 128);
+    BOOST_TEST(vec[23] == '7');
+
+    // Non trivial types are still default constructed
+    Vector<std::string> strings;
+    strings.resize_for_overwrite(3);
+    BOOST_TEST(strings.size() == 3);
+    BOOST_TEST(strings[2].empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(huge_vector){
+    // Grows through mremap, across the huge page threshold
+    HugeVector<std::size_t> vec;
+    constexpr std::size_t count = 1 << 20;
+    for(std::size_t i = 0; i < count; ++i){
+        vec.push_back(i);
+    }
+    BOOST_TEST(vec.size() == count);
+    BOOST_TEST(vec.capacity() == count);
+
+    vec.reserve(count * 4);
+    vec.resize(count / 2);
+    vec.shrink_to_fit();
+    BOOST_TEST(vec.capacity() == count / 2);
+
+    bool intact = true;
+    for(std::size_t i = 0; i < vec.size(); ++i){
+        intact = intact && vec[i] == i;
+    }
+    BOOST_TEST(intact);
+
+    // Copies and non trivially relocatable types use the same mappings
+    HugeVector<std::size_t> copy(vec);
+    BOOST_TEST(copy[count / 2 - 1] == count / 2 - 1);
+
+    HugeVector<std::string> strings;
+    for(int i = 0; i < 1000; ++i){
+        strings.push_back(std::to_string(i));
+    }
+    BOOST_TEST(strings[999] == "999");
+}
+
+
+BOOST_AUTO_TEST_CASE(mapped_vector){
+    struct Row{
+        std::uint32_t key;
+        double value;
+    };
+
+    Vector<Row> table;
+    for(std::uint32_t i = 0; i < 1000; ++i){
+        table.push_back(Row{i, i * 0.5});
+    }
+
+    char path[] = "/tmp/mapped_vector_XXXXXX";
+    const int fd = mkstemp(path);
+    BOOST_REQUIRE(fd >= 0);
+    close(fd);
+
+    MappedVector<Row>::write(path, table);
+
+    // The mapped elements match the written ones
+    MappedVector<Row> mapped(path);
+    BOOST_TEST(mapped.size() == 1000);
+    BOOST_TEST(reinterpret_cast<std::uintptr_t>(mapped.data()) % alignof(Row) == 0);
+    std::size_t idx = 0;
+    for(const Row& row : mapped){
+        BOOST_TEST(row.key == table[idx].key);
+        BOOST_TEST(row.value == table[idx].value);
+        ++idx;
+    }
+    BOOST_TEST(mapped.back().key == 999);
+    BOOST_CHECK_THROW(static_cast<void>(mapped.at(1000)), std::out_of_range);
+
+    // Moving hands over the mapping
+    MappedVector<Row> moved(std::move(mapped));
+    BOOST_TEST(moved[10].key == 10);
+    BOOST_TEST(mapped.empty());
+
+    // Files written for another type are rejected
+    BOOST_CHECK_THROW(MappedVector<std::uint64_t>{path}, std::runtime_error);
+    BOOST_CHECK_THROW(MappedVector<Row>{"/nonexistent/mapped_vector"}, std::runtime_error);
+
+    // Empty vectors round trip too
+    MappedVector<Row>::write(path, Vector<Row>());
+    BOOST_TEST(MappedVector<Row>(path).empty());
+
+    // A file cut off inside the padding after the header is rejected
+    struct alignas(64) Line{
+        std::uint64_t word;
+    };
+    MappedVector<Line>::write(path, Vector<Line>(3, Line{1}));
+    BOOST_REQUIRE(truncate(path, 48) == 0);
+    BOOST_CHECK_THROW(MappedVector<Line>{path}, std::runtime_error);
+
+    std::remove(path);
+}
+
+
+BOOST_AUTO_TEST_CASE(soa_vector){
+    SoaVector<int, double, std::string> vec;
+    for(int i = 0; i < 10; ++i){
+        vec.push_back(i, i * 1.5, std::to_string(i));
+    }
+    vec.emplace_back(10, 15.0, "xxx");
+
+    // Every column grows together
+    BOOST_TEST(vec.size() == 11);
+    BOOST_TEST(vec.capacity() == 16);
+
+    // Columns are contiguous spans
+    std::span<int> ids = vec.column<0>();
+    BOOST_TEST(ids.size() == 11);
+    int sum = 0;
+    for(const int id : ids){
+        sum += id;
+    }
+    BOOST_TEST(sum == 55);
+    BOOST_TEST(vec.column<2>()[10] == "xxx");
+
+    // Rows are proxies that write through to the columns
+    auto [id, value, name] = vec[3];
+    id = 30;
+    value = -1;
+    name = "three";
+    BOOST_TEST(vec.column<0>()[3] == 30);
+    BOOST_TEST(vec.column<1>()[3] == -1);
+    BOOST_TEST(std::get<2>(vec.at(3)) == "three");
+    BOOST_CHECK_THROW(static_cast<void>(vec.at(11)), std::out_of_range);
+
+    // The zip iterator walks rows
+    std::size_t rows = 0;
+    for(auto row : vec){
+        std::get<1>(row) += 1;
+        ++rows;
+    }
+    BOOST_TEST(rows == 11);
+    BOOST_TEST(vec.column<1>()[0] == 1.0);
+    BOOST_TEST(std::get<0>(*(vec.cbegin() + 4)) == 4);
+    BOOST_TEST((vec.end() - vec.begin()) == 11);
+
+    vec.pop_back();
+    vec.shrink_to_fit();
+    BOOST_TEST(vec.size() == 10);
+    BOOST_TEST(vec.capacity() == 10);
+    BOOST_TEST(std::get<2>(vec.back()) == "9");
+
+    const SoaVector<int, double, std::string> copy(vec);
+    BOOST_TEST(std::get<2>(copy.front()) == "0");
+    BOOST_TEST(copy.column<0>()[3] == 30);
+}
+
+
+BOOST_AUTO_TEST_CASE(soa_vector_exception_safety){
+    {
+        SoaVector<int, Throwing_Copy> vec;
+        for(int i = 0; i < 3; ++i) vec.emplace_back(i, i);
+
+        // The int column grows before the Throwing_Copy column throws on its second new row, both are shrunk back
+        vec.reserve(10);
+        Throwing_Copy::countdown = 1;
+        BOOST_CHECK_THROW(vec.resize(10), std::runtime_error);
+        Throwing_Copy::countdown = -1;
+        BOOST_TEST(vec.size() == 3);
+        BOOST_TEST(Throwing_Copy::live == 3);
+
+        vec.resize(5);
+        BOOST_TEST(vec.size() == 5);
+        BOOST_TEST(std::get<1>(vec[2]).val == 2);
+        BOOST_TEST(Throwing_Copy::live == 5);
+    }
+    BOOST_TEST(Throwing_Copy::live == 0);
+}
+
+
+// Checks every kernel at every level against a plain loop over vec
+template<class T>
+void check_kernels(const Vector<T>& vec, const T needle){
+    std::size_t first = vec.size();
+    std::size_t matches = 0;
+    T low = vec[0];
+    T high = vec[0];
+    for(std::size_t i = 0; i < vec.size(); ++i){
+        if(vec[i] == needle && first == vec.size()) first = i;
+        matches += vec[i] == needle;
+        low = vec[i] < low ? vec[i] : low;
+        high = high < vec[i] ? vec[i] : high;
+    }
+
+    Vector<T> other(vec);
+    const auto reference_sum = simd_sum(vec, Simd_Level::Scalar);
+    for(const Simd_Level level : {Simd_Level::Scalar, Simd_Level::SSE2, Simd_Level::AVX2, Simd_Level::AVX512}){
+        BOOST_TEST(simd_find(vec, needle, level) == first);
+        BOOST_TEST(simd_count(vec, needle, level) == matches);
+        BOOST_TEST(simd_min(vec, level) == low);
+        BOOST_TEST(simd_max(vec, level) == high);
+        BOOST_TEST(simd_equal(vec, other, level));
+
+        // Every level adds in the same order, so even floating point sums match bit for bit
+        const auto total = simd_sum(vec, level);
+        BOOST_TEST(std::memcmp(&total, &reference_sum, sizeof(total)) == 0);
+
+        const T changed = static_cast<T>(needle + 1);
+        other[other.size() - 3] = changed == other[other.size() - 3] ? needle : changed;
+        BOOST_TEST(!simd_equal(vec, other, level));
+        other[other.size() - 3] = vec[vec.size() - 3];
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(simd_kernels){
+    // Odd sizes so every kernel also runs its tail loop
+    Vector<std::int32_t> ints;
+    Vector<std::int64_t> longs;
+    Vector<float> floats;
+    Vector<double> doubles;
+    Vector<std::uint8_t> bytes;
+    for(std::size_t i = 0; i < 1037; ++i){
+        const std::int64_t v = static_cast<std::int64_t>((i * 7919) % 1000) - 500;
+        ints.push_back(static_cast<std::int32_t>(v));
+        longs.push_back(v * 1000000007);
+        floats.push_back(static_cast<float>(v) * 0.1f);
+        doubles.push_back(static_cast<double>(v) / 3.0);
+        bytes.push_back(static_cast<std::uint8_t>(i * 31));
+    }
+
+    check_kernels(ints, ints[900]);
+    check_kernels(longs, longs[700]);
+    check_kernels(floats, floats[1030]);
+    check_kernels(doubles, doubles[5]);
+    check_kernels(bytes, std::uint8_t{7});
+    check_kernels(ints, 123456);
+
+    // popcount gives the same count at every level
+    Vector<std::uint64_t> words;
+    std::size_t bits = 0;
+    for(std::size_t i = 0; i < 1037; ++i){
+        words.push_back(static_cast<std::uint64_t>(longs[i]) * 0x9e3779b97f4a7c15ULL);
+        bits += static_cast<std::size_t>(std::popcount(words.back()));
+    }
+    for(const Simd_Level level : {Simd_Level::Scalar, Simd_Level::SSE2, Simd_Level::AVX2, Simd_Level::AVX512}){
+        BOOST_TEST(simd_popcount(words, level) == bits);
+    }
+
+    // Integer sums wrap in 64 bits instead of overflowing the element type
+    const Vector<std::int32_t> big(3, 2000000000);
+    BOOST_TEST(simd_sum(big) == 6000000000LL);
+
+    // NaNs are only picked when they come first
+    Vector<double> nan{1.0, std::nan(""), -2.0};
+    BOOST_TEST(simd_min(nan) == -2.0);
+    BOOST_TEST(simd_find(nan, std::nan("")) == 3);
+    nan[0] = std::nan("");
+    BOOST_TEST(std::isnan(simd_max(nan)));
+
+    const Vector<float> empty;
+    BOOST_CHECK_THROW(static_cast<void>(simd_min(empty)), std::out_of_range);
+    BOOST_TEST(simd_sum(empty) == 0.0f);
+    BOOST_TEST(simd_find(empty, 1.0f) == 0);
+    BOOST_TEST(!simd_equal(empty, floats));
+}
+
+
+BOOST_AUTO_TEST_CASE(aligned_vector){
+    AlignedVector<float> vec;
+    for(int i = 0; i < 37; ++i){
+        vec.push_back(static_cast<float>(i));
+    }
+    const auto aligned = [](const void* p){ return reinterpret_cast<std::uintptr_t>(p) % 64 == 0; };
+
+    // Capacities are whole cache lines of floats
+    BOOST_TEST(aligned(vec.data()));
+    BOOST_TEST(vec.capacity() % 16 == 0);
+    BOOST_TEST(vec.capacity() >= 37);
+
+    vec.reserve(100);
+    BOOST_TEST(aligned(vec.data()));
+    BOOST_TEST(vec.capacity() == 112);
+    BOOST_TEST(vec[36] == 36.0f);
+
+    vec.shrink_to_fit();
+    BOOST_TEST(aligned(vec.data()));
+    BOOST_TEST(vec.capacity() == 48);
+    const float* before = vec.data();
+    vec.shrink_to_fit();
+    BOOST_TEST(vec.data() == before);
+
+    vec.resize(49);
+    BOOST_TEST(aligned(vec.data()));
+    BOOST_TEST(vec.capacity() == 64);
+
+    const AlignedVector<float> copy(vec);
+    BOOST_TEST(aligned(copy.data()));
+    BOOST_TEST(copy.size() == 49);
+    BOOST_TEST(copy[20] == 20.0f);
+
+    // Wider alignments and element types that do not divide the alignment
+    AlignedVector<std::string, 128> strings;
+    strings.push_back("aligned");
+    strings.emplace(0, "first");
+    BOOST_TEST(reinterpret_cast<std::uintptr_t>(strings.data()) % 128 == 0);
+    BOOST_TEST(strings[1] == "aligned");
+
+    // The default allocator is not padded
+    Vector<float> plain(5);
+    plain.shrink_to_fit();
+    BOOST_TEST(plain.capacity() == 5);
+}
+
+
+BOOST_AUTO_TEST_CASE(parallel_algorithms){
+    // More participants than cores, with small chunks so every participant gets work
+    Thread_Pool pool(4);
+    BOOST_TEST(pool.size() == 4);
+    const Parallel_Options options{100, false, &pool};
+
+    Vector<int> vec(10007);
+    parallel_fill(vec, 3, options);
+    BOOST_TEST(std::count(vec.begin(), vec.end(), 3) == 10007);
+
+    parallel_for_each(vec, [](int& x){ x += 1; }, options);
+    BOOST_TEST(vec[0] == 4);
+    BOOST_TEST(vec[10006] == 4);
+
+    for(std::size_t i = 0; i < vec.size(); ++i){
+        vec[i] = static_cast<int>(i);
+    }
+    Vector<long long> squares;
+    parallel_transform(vec, squares, [](const int x){ return static_cast<long long>(x) * x; }, options);
+    BOOST_TEST(squares.size() == 10007);
+    BOOST_TEST(squares[10006] == 10006LL * 10006LL);
+
+    Vector<int> copy;
+    parallel_copy(vec, copy, options);
+    BOOST_TEST(copy.size() == vec.size());
+    BOOST_TEST(std::equal(copy.begin(), copy.end(), vec.begin()));
+
+    const long long total = parallel_reduce(vec, 7LL, [](const long long a, const long long b){ return a + b; }, options);
+    BOOST_TEST(total == 7LL + 10006LL * 10007LL / 2);
+    BOOST_TEST(parallel_reduce(Vector<int>(), 5, [](int a, int b){ return a + b; }, options) == 5);
+
+    // Non-commutative operations keep the order of the chunks
+    Vector<std::string> words;
+    for(int i = 0; i < 50; ++i){
+        words.push_back(std::string(1, static_cast<char>('a' + i % 26)));
+    }
+    const std::string joined = parallel_reduce(words, std::string(">"), [](std::string a, const std::string& b){ return a + b; },
+                                               Parallel_Options{3, false, &pool});
+    BOOST_TEST(joined == ">abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwx");
+
+    // Chunks handed to the threads in any order are still joined in index order
+    Vector<std::string> tags;
+    std::string expected_tags;
+    for(int i = 0; i < 2000; ++i){
+        tags.push_back(std::to_string(i) + ",");
+        expected_tags += tags.back();
+    }
+    for(int run = 0; run < 20; ++run){
+        // Yielding lets every thread take chunks
+        const std::string tagged = parallel_reduce(tags, std::string(), [](std::string a, const std::string& b){
+            std::this_thread::yield();
+            return a + b;
+        }, Parallel_Options{1, false, &pool});
+        BOOST_REQUIRE(tagged == expected_tags);
+    }
+
+    // Float sums are bit identical for every thread count
+    Vector<float> floats;
+    for(int i = 0; i < 100000; ++i){
+        floats.push_back(1.0f / static_cast<float>(i + 1));
+    }
+    Thread_Pool single(1);
+    const auto add = [](const float a, const float b){ return a + b; };
+    const float one = parallel_reduce(floats, 0.0f, add, Parallel_Options{1000, false, &single});
+    const float four = parallel_reduce(floats, 0.0f, add, Parallel_Options{1000, false, &pool});
+    BOOST_TEST(std::memcmp(&one, &four, sizeof(one)) == 0);
+
+    // Nested jobs run inline instead of deadlocking
+    Vector<int> counts(8);
+    parallel_for_each(counts, [&](int& x){
+        x = static_cast<int>(parallel_reduce(vec, 0LL, [](const long long a, const long long b){ return a + b; }, options) % 1000);
+    }, Parallel_Options{1, false, &pool});
+    BOOST_TEST(counts[7] == static_cast<int>((10006LL * 10007LL / 2) % 1000));
+
+    // The first exception is rethrown on the caller
+    BOOST_CHECK_THROW(parallel_for_each(vec, [](const int x){ if(x == 5000) throw std::runtime_error("bad element"); }, options),
+                      std::runtime_error);
+
+    // The pool is still usable afterwards
+    parallel_fill(vec, 1, options);
+    BOOST_TEST(parallel_reduce(vec, 0, [](const int a, const int b){ return a + b; }, options) == 10007);
+}
+
+
+BOOST_AUTO_TEST_CASE(radix_sort_keys){
+    std::mt19937_64 rng(12345);
+
+    Vector<std::int32_t> ints;
+    Vector<std::uint64_t> longs;
+    Vector<double> doubles;
+    Vector<float> floats;
+    for(int i = 0; i < 5000; ++i){
+        ints.push_back(static_cast<std::int32_t>(rng()));
+        longs.push_back(rng());
+        doubles.push_back(std::ldexp(static_cast<double>(static_cast<std::int64_t>(rng())), -40));
+        floats.push_back(static_cast<float>(static_cast<std::int32_t>(rng() % 2001) - 1000) / 7.0f);
+    }
+    floats.push_back(std::numeric_limits<float>::infinity());
+    floats.push_back(-std::numeric_limits<float>::infinity());
+    floats.push_back(-0.0f);
+
+    radix_sort(ints);
+    radix_sort(longs);
+    radix_sort(doubles);
+    radix_sort(floats);
+    BOOST_TEST(std::is_sorted(ints.begin(), ints.end()));
+    BOOST_TEST(std::is_sorted(longs.begin(), longs.end()));
+    BOOST_TEST(std::is_sorted(doubles.begin(), doubles.end()));
+    BOOST_TEST(std::is_sorted(floats.begin(), floats.end()));
+    BOOST_TEST(floats.front() == -std::numeric_limits<float>::infinity());
+    BOOST_TEST(floats.back() == std::numeric_limits<float>::infinity());
+
+    // Keys sharing their high bytes skip those passes, and small types need a single pass
+    Vector<std::int16_t> shorts{5, -3, 300, -300, 0, 7, -32768, 32767};
+    radix_sort(shorts);
+    BOOST_TEST(std::is_sorted(shorts.begin(), shorts.end()));
+    Vector<std::uint8_t> bytes{9, 3, 255, 0, 3};
+    radix_sort(bytes);
+    BOOST_TEST(bytes[0] == 0);
+    BOOST_TEST(bytes[4] == 255);
+
+    // Records sort stably by an extracted key
+    struct Row{
+        std::int64_t key;
+        std::size_t order;
+    };
+    Vector<Row> rows;
+    for(std::size_t i = 0; i < 3000; ++i){
+        rows.push_back(Row{static_cast<std::int64_t>(rng() % 100) - 50, i});
+    }
+    radix_sort(rows, [](const Row& row){ return row.key; });
+    for(std::size_t i = 1; i < rows.size(); ++i){
+        BOOST_TEST((rows[i - 1].key < rows[i].key || (rows[i - 1].key == rows[i].key && rows[i - 1].order < rows[i].order)));
+    }
+
+    // Non trivial elements are moved through the scratch buffer
+    Vector<std::string> words{"pear", "fig", "apple", "kiwi"};
+    radix_sort(words, [](const std::string& word){ return static_cast<std::uint32_t>(word.size()); });
+    BOOST_TEST(words[0] == "fig");
+    BOOST_TEST(words[3] == "apple");
+    BOOST_TEST(((words[1] == "pear" && words[2] == "kiwi")));
+
+    Vector<int> empty;
+    radix_sort(empty);
+    BOOST_TEST(empty.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(parallel_sort_comparators){
+    std::mt19937_64 rng(777);
+    Thread_Pool pool(4);
+
+    // Uneven sizes and small grains so every level of merges is cut into pieces
+    for(const std::size_t n : {std::size_t(0), std::size_t(1), std::size_t(999), std::size_t(10007)}){
+        Vector<int> vec;
+        for(std::size_t i = 0; i < n; ++i){
+            vec.push_back(static_cast<int>(rng() % 1000));
+        }
+        Vector<int> expected(vec);
+        std::sort(expected.data(), expected.data() + expected.size());
+
+        parallel_sort(vec, std::less<>(), Parallel_Options{50, false, &pool});
+        BOOST_TEST(vec.size() == n);
+        BOOST_TEST(std::equal(vec.data(), vec.data() + n, expected.data()));
+    }
+
+    // Custom comparators and elements that are not trivially copyable
+    Vector<std::string> words;
+    for(int i = 0; i < 3001; ++i){
+        words.push_back(std::to_string(rng() % 100000));
+    }
+    parallel_sort(words, [](const std::string& a, const std::string& b){ return a.size() != b.size() ? a.size() > b.size() : a < b; },
+                  Parallel_Options{100, false, &pool});
+    for(std::size_t i = 1; i < words.size(); ++i){
+        BOOST_TEST((words[i - 1].size() > words[i].size() || (words[i - 1].size() == words[i].size() && words[i - 1] <= words[i])));
+    }
+
+    // Three participants split into two runs, the result ends in the scratch buffer and is moved back
+    Thread_Pool three(3);
+    Vector<double> doubles;
+    for(int i = 0; i < 5000; ++i){
+        doubles.push_back(static_cast<double>(rng() % 10000) / 3.0);
+    }
+    parallel_sort(doubles, std::greater<>(), Parallel_Options{100, false, &three});
+    BOOST_TEST(std::is_sorted(doubles.begin(), doubles.end(), std::greater<>()));
+}
+
+
+BOOST_AUTO_TEST_CASE(concurrent_vector){
+    ConcurrentVector<std::size_t> vec;
+    BOOST_TEST(vec.empty());
+    BOOST_CHECK_THROW(static_cast<void>(vec.begin()), std::out_of_range);
+
+    // Elements never move, even as later segments are added
+    const std::size_t first = vec.push_back(100);
+    const std::size_t* address = &vec[first];
+    for(std::size_t i = 1; i < 1000; ++i){
+        BOOST_TEST(vec.push_back(i * 100) == i);
+    }
+    BOOST_TEST(&vec[0] == address);
+    BOOST_TEST(vec.size() == 1000);
+    BOOST_TEST(vec.capacity() >= 1000);
+    BOOST_TEST(vec[15] == 1500);
+    BOOST_TEST(vec[16] == 1600);
+    BOOST_TEST(vec.at(999) == 99900);
+    BOOST_TEST(vec.ready(999));
+    BOOST_TEST(!vec.ready(1000));
+    BOOST_CHECK_THROW(static_cast<void>(vec.at(1000)), std::out_of_range);
+    BOOST_TEST((vec.end() - vec.begin()) == 1000);
+    BOOST_TEST(*(vec.cbegin() + 500) == 50000);
+
+    // Producers append while a reader checks every element it sees as ready
+    ConcurrentVector<std::size_t> shared;
+    shared.reserve(100);
+    constexpr std::size_t THREADS = 4;
+    constexpr std::size_t PER_THREAD = 20000;
+    std::atomic<bool> wrong{false};
+    std::atomic<std::size_t> producing{THREADS};
+    Vector<std::thread> threads;
+    for(std::size_t t = 0; t < THREADS; ++t){
+        threads.emplace_back([&shared, &producing, t]{
+            for(std::size_t i = 0; i < PER_THREAD; ++i){
+                const std::size_t idx = shared.push_back(t * PER_THREAD + i);
+                if(shared[idx] != t * PER_THREAD + i) std::abort();
+            }
+            producing.fetch_sub(1);
+        });
+    }
+    threads.emplace_back([&]{
+        while(producing.load() > 0){
+            const std::size_t seen = shared.size();
+            for(std::size_t i = seen > 64 ? seen - 64 : 0; i < seen; ++i){
+                if(shared.ready(i) && shared[i] >= THREADS * PER_THREAD) wrong = true;
+            }
+        }
+    });
+    for(std::size_t t = 0; t < threads.size(); ++t){
+        threads[t].join();
+    }
+    BOOST_TEST(!wrong);
+    BOOST_TEST(shared.size() == THREADS * PER_THREAD);
+
+    // Every value was added exactly once
+    Vector<int> seen(THREADS * PER_THREAD);
+    for(const std::size_t value : shared){
+        ++seen[value];
+    }
+    BOOST_TEST(std::count(seen.begin(), seen.end(), 1) == static_cast<std::ptrdiff_t>(THREADS * PER_THREAD));
+
+    // Non trivial elements are destroyed
+    ConcurrentVector<std::string> words;
+    words.emplace_back(5, 'x');
+    words.push_back("concurrent");
+    BOOST_TEST(words[0] == "xxxxx");
+    words.clear();
+    BOOST_TEST(words.empty());
+    words.push_back("again");
+    BOOST_TEST(words[0] == "again");
+}
+
+
+BOOST_AUTO_TEST_CASE(stable_vector){
+    StableVector<int> vec;
+    BOOST_CHECK_THROW(static_cast<void>(vec.begin()), std::out_of_range);
+
+    // Pointers stay valid while the vector grows
+    vec.push_back(0);
+    int* first = &vec[0];
+    Vector<int*> addresses;
+    for(int i = 1; i < 5000; ++i){
+        vec.push_back(i);
+        if(i % 97 == 0) addresses.push_back(&vec[static_cast<std::size_t>(i)]);
+    }
+    BOOST_TEST(first == &vec.front());
+    BOOST_TEST(*first == 0);
+    for(std::size_t i = 0; i < addresses.size(); ++i){
+        BOOST_TEST(*addresses[i] == static_cast<int>((i + 1) * 97));
+    }
+    BOOST_TEST(vec.size() == 5000);
+    BOOST_TEST(vec.capacity() >= 5000);
+    BOOST_TEST(vec[15] == 15);
+    BOOST_TEST(vec[16] == 16);
+    BOOST_TEST(vec.at(4999) == 4999);
+    BOOST_TEST(vec.back() == 4999);
+    BOOST_CHECK_THROW(static_cast<void>(vec.at(5000)), std::out_of_range);
+
+    // Chunks double in size and together cover every element
+    BOOST_TEST(vec.chunk(0).size() == 16);
+    BOOST_TEST(vec.chunk(1).size() == 32);
+    BOOST_TEST(vec.chunk(1)[0] == 16);
+    std::size_t covered = 0;
+    for(std::size_t s = 0; s < vec.chunk_count(); ++s){
+        covered += vec.chunk(s).size();
+    }
+    BOOST_TEST(covered == 5000);
+    BOOST_TEST(vec.chunk(60).empty());
+
+    // The iterators are random access, like Vector's
+    std::reverse(vec.begin(), vec.end());
+    BOOST_TEST(vec[0] == 4999);
+    std::sort(vec.begin(), vec.end());
+    BOOST_TEST(std::is_sorted(vec.cbegin(), vec.cend()));
+    BOOST_TEST(*first == 0);
+    BOOST_TEST((vec.end() - vec.begin()) == 5000);
+    BOOST_TEST(vec.begin()[100] == 100);
+
+    // pop_back and clear keep the chunks, shrink_to_fit frees the unused ones
+    const std::size_t capacity = vec.capacity();
+    while(vec.size() > 20) vec.pop_back();
+    BOOST_TEST(vec.capacity() == capacity);
+    vec.shrink_to_fit();
+    BOOST_TEST(vec.capacity() == 48);
+    BOOST_TEST(first == &vec[0]);
+    vec.resize(100);
+    BOOST_TEST(vec[99] == 0);
+    BOOST_TEST(vec[19] == 19);
+
+    // Copies hold their own elements, moves hand over the chunks
+    StableVector<std::string> words{"alpha", "beta"};
+    words.emplace_back(3, 'c');
+    std::string* beta = &words[1];
+    StableVector<std::string> copy(words);
+    copy[1] = "changed";
+    BOOST_TEST(words[1] == "beta");
+    StableVector<std::string> moved(std::move(words));
+    BOOST_TEST(&moved[1] == beta);
+    BOOST_TEST(moved[2] == "ccc");
+    BOOST_TEST(words.empty());
+    words = moved;
+    BOOST_TEST(words.size() == 3);
+    words.clear();
+    BOOST_TEST(words.empty());
+    words.push_back("again");
+    BOOST_TEST(words.front() == "again");
+}
+
+
+BOOST_AUTO_TEST_CASE(flat_set){
+    // Bulk construction sorts and drops duplicates
+    FlatSet<int> set{5, 1, 9, 1, 3, 5, 7};
+    BOOST_TEST(set.size() == 5);
+    BOOST_TEST(std::is_sorted(set.begin(), set.end()));
+    BOOST_TEST(set.contains(7));
+    BOOST_TEST(!set.contains(4));
+    BOOST_TEST(set.find(9) == 4);
+    BOOST_TEST(set.find(10) == set.size());
+    BOOST_TEST(set.lower_bound(0) == 0);
+    BOOST_TEST(set.lower_bound(4) == 2);
+    BOOST_TEST(set.lower_bound(100) == 5);
+    BOOST_TEST(set.count(3) == 1);
+
+    // The branchless search matches std::lower_bound at every position of every size
+    for(int n = 0; n < 40; ++n){
+        Vector<int> odd;
+        for(int i = 0; i < n; ++i) odd.push_back(2 * i + 1);
+        for(int key = -1; key <= 2 * n + 1; ++key){
+            const std::size_t expected = static_cast<std::size_t>(std::lower_bound(odd.data(), odd.data() + odd.size(), key) - odd.data());
+            BOOST_TEST(branchless_lower_bound(odd.data(), odd.size(), key, std::less<int>()) == expected);
+        }
+    }
+
+    // Single inserts keep the order and reject duplicates
+    BOOST_TEST(set.insert(4));
+    BOOST_TEST(!set.insert(4));
+    BOOST_TEST(set[2] == 4);
+    BOOST_TEST(set.erase(1));
+    BOOST_TEST(!set.erase(1));
+    BOOST_TEST(set.keys().front() == 3);
+
+    // Batched inserts merge an unsorted batch with duplicates of its own and of the set
+    set.insert({8, 2, 8, 100, 3, 0});
+    const Vector<int> expected{0, 2, 3, 4, 5, 7, 8, 9, 100};
+    BOOST_TEST(std::equal(set.begin(), set.end(), expected.begin(), expected.end()));
+    set.insert({});
+    BOOST_TEST(set.size() == expected.size());
+
+    // A comparator orders the keys, and a Vector can be adopted
+    FlatSet<std::string, std::greater<>> words(Vector<std::string>{"b", "c", "a", "c"});
+    BOOST_TEST(words.size() == 3);
+    BOOST_TEST(words[0] == "c");
+    BOOST_TEST(words.contains("a"));
+    words.insert(std::string("d"));
+    BOOST_TEST(words[0] == "d");
+
+    // Random batches agree with std::set
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<int> dist(0, 5000);
+    FlatSet<int> random;
+    std::set<int> reference;
+    for(int round = 0; round < 20; ++round){
+        Vector<int> batch;
+        for(int i = 0; i < 300; ++i) batch.push_back(dist(gen));
+        random.insert(batch.data(), batch.data() + batch.size());
+        reference.insert(batch.data(), batch.data() + batch.size());
+    }
+    BOOST_TEST(random.size() == reference.size());
+    BOOST_TEST(std::equal(random.begin(), random.end(), reference.begin()));
+
+    set.clear();
+    BOOST_TEST(set.empty());
+    BOOST_TEST(!set.contains(0));
+    BOOST_CHECK_THROW(static_cast<void>(set.begin()), std::out_of_range);
+}
+
+
+BOOST_AUTO_TEST_CASE(flat_map){
+    // Bulk construction keeps the first value of every repeated key
+    FlatMap<int, std::string> map{{3, "three"}, {1, "one"}, {3, "again"}, {2, "two"}};
+    BOOST_TEST(map.size() == 3);
+    const Vector<int> keys{1, 2, 3};
+    BOOST_TEST(std::equal(map.keys().begin(), map.keys().end(), keys.begin(), keys.end()));
+    BOOST_TEST(map.at(3) == "three");
+    BOOST_TEST(map.values()[0] == "one");
+    BOOST_CHECK_THROW(static_cast<void>(map.at(4)), std::out_of_range);
+
+    // insert keeps existing values, insert_or_assign and operator[] overwrite
+    BOOST_TEST(!map.insert(2, "deux"));
+    BOOST_TEST(map.at(2) == "two");
+    BOOST_TEST(!map.insert_or_assign(2, "deux"));
+    BOOST_TEST(map.at(2) == "deux");
+    BOOST_TEST(map.insert(0, "zero"));
+    BOOST_TEST(map.find(0) == 0);
+    BOOST_TEST(map[5].empty());
+    map[5] = "five";
+    BOOST_TEST(map.value(map.find(5)) == "five");
+    BOOST_TEST(map.size() == 5);
+
+    // Batched inserts merge with the existing entries, existing values win
+    const Vector<std::pair<int, std::string>> batch{{4, "four"}, {1, "uno"}, {6, "six"}, {4, "vier"}};
+    map.insert(batch.cbegin(), batch.cend());
+    const Vector<int> merged{0, 1, 2, 3, 4, 5, 6};
+    BOOST_TEST(std::equal(map.keys().begin(), map.keys().end(), merged.begin(), merged.end()));
+    BOOST_TEST(map.at(1) == "one");
+    BOOST_TEST(map.at(4) == "four");
+
+    // Iterators yield key value tuples with const keys
+    int total = 0;
+    for(auto [key, value] : map){
+        total += key;
+        value += "!";
+    }
+    BOOST_TEST(total == 21);
+    BOOST_TEST(map.at(6) == "six!");
+    const auto& const_map = map;
+    BOOST_TEST(std::get<0>(*const_map.begin()) == 0);
+    BOOST_TEST((const_map.end() - const_map.begin()) == 7);
+
+    BOOST_TEST(map.erase(3));
+    BOOST_TEST(!map.erase(3));
+    BOOST_TEST(!map.contains(3));
+    BOOST_TEST(map.count(4) == 1);
+    BOOST_TEST(map.values().size() == map.keys().size());
+    map.clear();
+    BOOST_TEST(map.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(flat_map_exception_safety){
+    FlatMap<int, Throwing_Copy> map;
+    const Throwing_Copy elt(7);
+    for(int i = 0; i < 10; i += 2) BOOST_TEST(map.insert(i, elt));
+
+    // A value that fails to be added takes its key back out, the map is unchanged
+    Throwing_Copy::countdown = 0;
+    BOOST_CHECK_THROW(map.insert(9, elt), std::runtime_error);
+    Throwing_Copy::countdown = 0;
+    BOOST_CHECK_THROW(map.insert_or_assign(11, elt), std::runtime_error);
+    Throwing_Copy::countdown = 0;
+    BOOST_CHECK_THROW(static_cast<void>(map[13]), std::runtime_error);
+    Throwing_Copy::countdown = -1;
+
+    BOOST_TEST(map.size() == 5);
+    BOOST_TEST(map.keys().size() == map.values().size());
+    BOOST_TEST(!map.contains(9));
+    BOOST_TEST(!map.contains(11));
+    BOOST_TEST(!map.contains(13));
+    BOOST_TEST(map.at(8).val == 7);
+    BOOST_TEST(Throwing_Copy::live == 6);
+}
+
+
+// A key whose copies and moves throw once Throwing_Copy::countdown reaches zero
+// Moving leaves -1 behind, so a key moved out of a container shows up
+struct Throwing_Key{
+    int val;
+
+    explicit Throwing_Key(const int _val) :
+    val{_val} {}
+
+    Throwing_Key(const Throwing_Key& other) :
+    val{other.val} { Throwing_Copy::tick(); }
+
+    Throwing_Key(Throwing_Key&& other) :
+    val{other.val} { Throwing_Copy::tick(); other.val = -1; }
+
+    Throwing_Key& operator=(const Throwing_Key&) = default;
+    Throwing_Key& operator=(Throwing_Key&&) = default;
+
+    friend bool operator<(const Throwing_Key& a, const Throwing_Key& b) noexcept { return a.val < b.val; }
+};
+
+
+BOOST_AUTO_TEST_CASE(flat_batch_insert_exception_safety){
+    const Vector<Throwing_Key> extra{Throwing_Key(5), Throwing_Key(1), Throwing_Key(9)};
+    const Vector<std::pair<Throwing_Key, int>> extra_keys{{Throwing_Key(5), 5}, {Throwing_Key(1), 1}, {Throwing_Key(9), 9}};
+    const Vector<std::pair<int, Throwing_Key>> extra_values{{5, Throwing_Key(5)}, {1, Throwing_Key(1)}, {9, Throwing_Key(9)}};
+
+    FlatSet<Throwing_Key> set;
+    FlatMap<Throwing_Key, int> by_key;
+    FlatMap<int, Throwing_Key> by_value;
+    for(int i = 0; i < 10; i += 2){
+        set.insert(Throwing_Key(i));
+        by_key.insert(Throwing_Key(i), i);
+        by_value.insert(i, Throwing_Key(i));
+    }
+
+    // Throw at every copy or move in turn, a failed batch leaves the entries untouched
+    const auto unchanged = [](const auto& keys, const auto& key_of){
+        for(std::size_t i = 0; i < keys.size(); ++i){
+            if(key_of(keys[i]) != static_cast<int>(2 * i)) return false;
+        }
+        return keys.size() == 5;
+    };
+    for(int countdown = 0;; ++countdown){
+        Throwing_Copy::countdown = countdown;
+        try{
+            set.insert(extra.begin(), extra.end());
+        }catch(const std::runtime_error&){
+            BOOST_REQUIRE(unchanged(set.keys(), [](const Throwing_Key& k){ return k.val; }));
+            continue;
+        }
+        break;
+    }
+    for(int countdown = 0;; ++countdown){
+        Throwing_Copy::countdown = countdown;
+        try{
+            by_key.insert(extra_keys.begin(), extra_keys.end());
+        }catch(const std::runtime_error&){
+            BOOST_REQUIRE(unchanged(by_key.keys(), [](const Throwing_Key& k){ return k.val; }));
+            BOOST_REQUIRE(by_key.values().size() == 5);
+            continue;
+        }
+        break;
+    }
+    for(int countdown = 0;; ++countdown){
+        Throwing_Copy::countdown = countdown;
+        try{
+            by_value.insert(extra_values.begin(), extra_values.end());
+        }catch(const std::runtime_error&){
+            BOOST_REQUIRE(unchanged(by_value.values(), [](const Throwing_Key& k){ return k.val; }));
+            continue;
+        }
+        break;
+    }
+    Throwing_Copy::countdown = -1;
+
+    BOOST_TEST(set.size() == 8);
+    BOOST_TEST(by_key.size() == 8);
+    BOOST_TEST(by_value.size() == 8);
+    BOOST_TEST(set.keys()[8 - 1].val == 9);
+    BOOST_TEST(by_key.at(Throwing_Key(5)) == 5);
+    BOOST_TEST(by_value.at(4).val == 4);
+}
+
+
+BOOST_AUTO_TEST_CASE(bit_vector){
+    // Bits are packed 64 to a word
+    BitVector bits{true, false, true, true};
+    BOOST_TEST(bits.size() == 4);
+    BOOST_TEST(bits.words().size() == 1);
+    BOOST_TEST(bits.data()[0] == 0b1101);
+    BOOST_TEST(bits.test(2));
+    BOOST_TEST(!bits[1]);
+    BOOST_CHECK_THROW(static_cast<void>(bits.test(4)), std::out_of_range);
+    BOOST_CHECK_THROW(bits.set(4), std::out_of_range);
+
+    bits.set(1);
+    bits.reset(0);
+    bits.flip(3);
+    BOOST_TEST(bits.data()[0] == 0b0110);
+    BOOST_TEST(bits.count() == 2);
+    bits.pop_back();
+    BOOST_TEST(bits.size() == 3);
+
+    // Whole vector operations keep the bits past size() clear
+    BitVector wide(130, true);
+    BOOST_TEST(wide.words().size() == 3);
+    BOOST_TEST(wide.count() == 130);
+    BOOST_TEST(wide.all());
+    BOOST_TEST(wide.data()[2] == 0b11);
+    wide.flip();
+    BOOST_TEST(wide.none());
+    wide.set();
+    BOOST_TEST(wide.count() == 130);
+    wide.resize(70);
+    BOOST_TEST(wide.count() == 70);
+    wide.resize(200, false);
+    BOOST_TEST(wide.count() == 70);
+    wide.resize(250, true);
+    BOOST_TEST(wide.count() == 120);
+    BOOST_TEST(!wide[199]);
+    BOOST_TEST(wide[200]);
+    BOOST_TEST((~wide).count() == 130);
+
+    // Set operations match a bit by bit reference at sizes around word boundaries
+    std::mt19937 gen(3);
+    for(const std::size_t n : {std::size_t(0), std::size_t(1), std::size_t(63), std::size_t(64), std::size_t(65), std::size_t(1000), std::size_t(70001)}){
+        BitVector a;
+        BitVector b;
+        std::vector<bool> ref_a;
+        std::vector<bool> ref_b;
+        for(std::size_t i = 0; i < n; ++i){
+            const bool x = gen() % 3 == 0;
+            const bool y = gen() % 2 == 0;
+            a.push_back(x);
+            b.push_back(y);
+            ref_a.push_back(x);
+            ref_b.push_back(y);
+        }
+
+        const BitVector both = a & b;
+        const BitVector either = a | b;
+        const BitVector one = a ^ b;
+        BitVector only_a(a);
+        only_a.and_not(b);
+        std::size_t set_in_a = 0;
+        bool ops_match = true;
+        for(std::size_t i = 0; i < n; ++i){
+            set_in_a += ref_a[i];
+            ops_match = ops_match && both[i] == (ref_a[i] && ref_b[i]) && either[i] == (ref_a[i] || ref_b[i])
+                        && one[i] == (ref_a[i] != ref_b[i]) && only_a[i] == (ref_a[i] && !ref_b[i]);
+        }
+        BOOST_TEST(ops_match);
+        BOOST_TEST(a.count() == set_in_a);
+        BOOST_TEST((((a ^ b) ^ b) == a));
+
+        // rank counts the set bits before an index, select inverts it
+        bool ranks_match = true;
+        std::size_t running = 0;
+        for(std::size_t i = 0; i <= n; ++i){
+            ranks_match = ranks_match && a.rank(i) == running;
+            if(i < n && ref_a[i]){
+                ranks_match = ranks_match && a.select(running) == i;
+                ++running;
+            }
+        }
+        BOOST_TEST(ranks_match);
+        BOOST_CHECK_THROW(static_cast<void>(a.select(set_in_a)), std::out_of_range);
+        BOOST_CHECK_THROW(static_cast<void>(a.rank(n + 1)), std::out_of_range);
+    }
+
+    // Changes after a query rebuild the index
+    BitVector dense(10000, true);
+    BOOST_TEST(dense.select(9000) == 9000);
+    dense.reset(0);
+    BOOST_TEST(dense.rank(10000) == 9999);
+    BOOST_TEST(dense.select(0) == 1);
+
+    BitVector small(10);
+    BOOST_CHECK_THROW(small &= dense, std::invalid_argument);
+    small.clear();
+    BOOST_TEST(small.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(cow_vector){
+    // Copies share the buffer until one of them changes
+    CowVector<std::string> original{"a", "b", "c"};
+    BOOST_TEST(original.use_count() == 1);
+    const CowVector<std::string> snapshot(original);
+    BOOST_TEST(original.use_count() == 2);
+    BOOST_TEST(snapshot.data() == std::as_const(original).data());
+
+    // Const reads never copy
+    BOOST_TEST(snapshot[1] == "b");
+    BOOST_TEST(std::as_const(original).at(2) == "c");
+    BOOST_TEST(*snapshot.begin() == "a");
+    BOOST_TEST(original.shared());
+
+    // The first mutation copies, later ones reuse the private buffer
+    original.push_back("d");
+    BOOST_TEST(!original.shared());
+    BOOST_TEST(!snapshot.shared());
+    BOOST_TEST(snapshot.size() == 3);
+    BOOST_TEST(original.size() == 4);
+    const std::string* own = std::as_const(original).data();
+    original[0] = "z";
+    BOOST_TEST(std::as_const(original).data() == own);
+    BOOST_TEST(snapshot[0] == "a");
+
+    // Mutable iterators, data() and at() also detach
+    CowVector<int> numbers{3, 1, 2};
+    CowVector<int> sorted(numbers);
+    std::sort(sorted.begin(), sorted.end());
+    BOOST_TEST(sorted[0] == 1);
+    BOOST_TEST(std::as_const(numbers)[0] == 3);
+    CowVector<int> written(numbers);
+    written.data()[1] = 10;
+    written.at(2) = 20;
+    BOOST_TEST(std::as_const(numbers)[1] == 1);
+    BOOST_TEST(std::as_const(written)[2] == 20);
+
+    // Assignment shares, clear leaves a shared buffer to the other vectors
+    CowVector<int> assigned;
+    BOOST_TEST(assigned.use_count() == 0);
+    assigned = numbers;
+    BOOST_TEST(numbers.use_count() == 2);
+    assigned.clear();
+    BOOST_TEST(assigned.empty());
+    BOOST_TEST(numbers.use_count() == 1);
+    BOOST_TEST(numbers.size() == 3);
+    CowVector<int> moved(std::move(numbers));
+    BOOST_TEST(numbers.empty());
+    BOOST_TEST(moved.use_count() == 1);
+    moved.erase(0, 2);
+    moved.insert(0, 7);
+    moved.pop_back();
+    BOOST_TEST(moved.size() == 1);
+    BOOST_TEST(moved.front() == 7);
+    BOOST_CHECK_THROW(static_cast<void>(assigned.begin()), std::out_of_range);
+    BOOST_CHECK_THROW(assigned.pop_back(), std::out_of_range);
+
+    // A reference handed out by a mutable accessor stops later copies from sharing the buffer
+    CowVector<int> leaked{1, 2};
+    int& first = leaked[0];
+    CowVector<int> snapped(leaked);
+    first = 5;
+    BOOST_TEST(std::as_const(snapped)[0] == 1);
+    BOOST_TEST(!leaked.shared());
+    CowVector<int> assigned_snap;
+    assigned_snap = leaked;
+    first = 6;
+    BOOST_TEST(std::as_const(assigned_snap)[0] == 5);
+
+    // Clearing invalidates the references, so copies share again
+    leaked.clear();
+    leaked.push_back(3);
+    CowVector<int> shares(leaked);
+    BOOST_TEST(leaked.use_count() == 2);
+
+    // A Vector can be adopted without copying
+    Vector<int> source(1000, 5);
+    const int* elements = source.data();
+    CowVector<int> adopted(std::move(source));
+    BOOST_TEST(std::as_const(adopted).data() == elements);
+
+    // Snapshots handed to threads stay unchanged while the owner keeps writing
+    CowVector<std::size_t> config(10000, 1);
+    Vector<std::thread> readers;
+    Vector<std::size_t> sums(4, 0);
+    for(std::size_t t = 0; t < 4; ++t){
+        readers.emplace_back([snap = CowVector<std::size_t>(config), &sums, t]{
+            for(std::size_t i = 0; i < snap.size(); ++i) sums[t] += snap[i];
+        });
+        config[t] = 100;
+    }
+    for(std::size_t t = 0; t < readers.size(); ++t){
+        readers[t].join();
+    }
+    BOOST_TEST(sums[0] == 10000);
+    BOOST_TEST(sums[3] == 10000 + 3 * 99);
+    BOOST_TEST(std::as_const(config)[3] == 100);
+}
+
+
+BOOST_AUTO_TEST_CASE(persistent_vector){
+    // Every push_back returns a new version and leaves the old one unchanged
+    Vector<PersistentVector<std::size_t>> versions;
+    versions.push_back(PersistentVector<std::size_t>());
+    constexpr std::size_t count = 40000;
+    for(std::size_t i = 0; i < count; ++i){
+        versions.push_back(versions.back().push_back(i * 3));
+    }
+    bool intact = true;
+    for(const std::size_t v : {std::size_t(0), std::size_t(1), std::size_t(32), std::size_t(33), std::size_t(1024), std::size_t(1057), std::size_t(33000), count}){
+        intact = intact && versions[v].size() == v;
+        for(std::size_t i = 0; i < v; ++i){
+            intact = intact && versions[v][i] == i * 3;
+        }
+    }
+    BOOST_TEST(intact);
+    BOOST_TEST(versions[0].empty());
+
+    // set copies the path to one element
+    const PersistentVector<std::size_t>& full = versions[count];
+    const PersistentVector<std::size_t> changed = full.set(5, 1).set(count - 1, 2).set(31000, 3);
+    BOOST_TEST(changed[5] == 1);
+    BOOST_TEST(changed[count - 1] == 2);
+    BOOST_TEST(changed[31000] == 3);
+    BOOST_TEST(full[5] == 15);
+    BOOST_TEST(full.back() == (count - 1) * 3);
+    BOOST_TEST(full.at(31000) == 93000);
+    BOOST_TEST(changed[6] == 18);
+    BOOST_CHECK_THROW(static_cast<void>(full.set(count, 0)), std::out_of_range);
+    BOOST_CHECK_THROW(static_cast<void>(full.at(count)), std::out_of_range);
+
+    // The iterators are random access
+    BOOST_TEST(std::is_sorted(full.begin(), full.end()));
+    BOOST_TEST((full.end() - full.begin()) == static_cast<std::ptrdiff_t>(count));
+    BOOST_TEST(*std::find(changed.begin(), changed.end(), 3) == 3);
+
+    // A transient changes its own nodes in place and leaves its source alone
+    TransientVector<std::size_t> builder = full.transient();
+    for(std::size_t i = 0; i < 2000; ++i){
+        builder.push_back(i);
+    }
+    for(std::size_t i = 0; i < count; i += 7){
+        builder.set(i, 0);
+    }
+    BOOST_TEST(builder.size() == count + 2000);
+    BOOST_TEST(builder[7] == 0);
+    BOOST_TEST(builder.at(count + 1999) == 1999);
+    BOOST_TEST(full[7] == 21);
+    BOOST_TEST(full.size() == count);
+    const PersistentVector<std::size_t> built = builder.persistent();
+    BOOST_TEST(builder.empty());
+    BOOST_TEST(built.size() == count + 2000);
+    BOOST_TEST(built[14] == 0);
+    BOOST_TEST(built[15] == 45);
+
+    // Versions of non-trivial elements are destroyed once the last version holding them goes
+    PersistentVector<std::string> words{"alpha", "beta"};
+    PersistentVector<std::string> more = words.push_back("gamma");
+    for(int i = 0; i < 100; ++i){
+        more = more.push_back(std::string(40, static_cast<char>('a' + i % 26)));
+    }
+    const PersistentVector<std::string> renamed = more.set(1, "delta");
+    more = PersistentVector<std::string>();
+    BOOST_TEST(words.size() == 2);
+    BOOST_TEST(renamed[1] == "delta");
+    BOOST_TEST(renamed[0] == "alpha");
+    BOOST_TEST(renamed.size() == 103);
+    BOOST_TEST(renamed.back() == std::string(40, 'v'));
+    BOOST_CHECK_THROW(static_cast<void>(more.begin()), std::out_of_range);
+
+    // Versions can be read and extended from several threads at once
+    Vector<std::thread> threads;
+    Vector<std::size_t> sums(4, 0);
+    for(std::size_t t = 0; t < 4; ++t){
+        threads.emplace_back([&full, &sums, t]{
+            PersistentVector<std::size_t> mine = full.set(t, 0);
+            for(std::size_t i = 0; i < 100; ++i) mine = mine.push_back(t);
+            for(std::size_t i = 0; i < mine.size(); ++i) sums[t] += mine[i];
+        });
+    }
+    for(std::size_t t = 0; t < threads.size(); ++t){
+        threads[t].join();
+    }
+    const std::size_t base = 3 * (count - 1) * count / 2;
+    BOOST_TEST(sums[2] == base - 6 + 200);
+    BOOST_TEST(full[2] == 6);
+}